@@ -1,7 +1,8 @@
 #ifndef LINE_FOLLOWER_H
 #define LINE_FOLLOWER_H
 
-#define DEBUG_MODE  // Comment to disable debug mode
+#define DEBUG_MODE      // Comment to disable debug mode
+#define PROFILING_MODE  // Comment to disable the control loop profiler
 
 #define BASE_SQUARE 0       // 0.5 meter square track (default)
 #define INVERSE_SQUARE 1    // 0.5 meter inverse square track
@@ -13,7 +14,9 @@
 #define PET_COMPLEX 7       // PET track with all waypoints
 #define WAYPOINT_TEST 8     // Test track for generated waypoints
 
-// Default selected track (override with -DSELECTED_TRACK=base_triangle)
+// Default selected track (override with -DSELECTED_TRACK=BASE_TRIANGLE)
+#ifndef SELECTED_TRACK
 #define SELECTED_TRACK PET_COMPLEX
+#endif
 
 #endif  // LINE_FOLLOWER_H
@@ -65,6 +65,36 @@ void USART1_IRQHandler(void);
  */
 uint32_t LL_GetTick(void);
 
+/**
+ * @brief Handles the TIM10 interrupt driving the inner control loop.
+ */
+void TIM1_UP_TIM10_IRQHandler(void);
+
+/**
+ * @brief Handles the TIM5 interrupt counting timebase overflows.
+ */
+void TIM5_IRQHandler(void);
+
+/**
+ * @brief Handle the EXTI interrupts capturing the IR sensor discharges.
+ */
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void EXTI4_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+
+/**
+ * @brief Handles the TIM11 interrupt sampling the side sensors.
+ */
+void TIM1_TRG_COM_TIM11_IRQHandler(void);
+
+/**
+ * @brief Handles the SPI2 RX DMA stream completing an MPU read.
+ */
+void DMA1_Stream3_IRQHandler(void);
+
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
@@ -22,6 +22,11 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "hal/control_timer.h"
+#include "hal/ir_sensors.h"
+#include "hal/spi.h"
+#include "hal/timer.h"
+#include "hal/watchdog.h"
 #include "hal/usart.h"
 /* USER CODE END Includes */
 
@@ -185,6 +190,7 @@ void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
     system_time_ms++;
+    watchdog_tick_handler();
 
   /* USER CODE END SysTick_IRQn 0 */
 
@@ -217,4 +223,24 @@ void USART1_IRQHandler(void)
 /* USER CODE BEGIN 1 */
 
 uint32_t LL_GetTick(void) { return system_time_ms; }
+
+void TIM1_UP_TIM10_IRQHandler(void) { control_timer_irq_handler(); }
+
+void TIM5_IRQHandler(void) { timebase_irq_handler(); }
+
+void EXTI0_IRQHandler(void) { ir_capture_irq_handler(); }
+
+void EXTI1_IRQHandler(void) { ir_capture_irq_handler(); }
+
+void EXTI3_IRQHandler(void) { ir_capture_irq_handler(); }
+
+void EXTI4_IRQHandler(void) { ir_capture_irq_handler(); }
+
+void EXTI9_5_IRQHandler(void) { ir_capture_irq_handler(); }
+
+void EXTI15_10_IRQHandler(void) { ir_capture_irq_handler(); }
+
+void TIM1_TRG_COM_TIM11_IRQHandler(void) { side_capture_irq_handler(); }
+
+void DMA1_Stream3_IRQHandler(void) { spi_dma_irq_handler(); }
 /* USER CODE END 1 */
@@ -0,0 +1,92 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+#define HOST_CLOCK_READ_COST_NS 500  // Virtual time consumed by each clock read
+
+/**
+ * @enum HostClockModes
+ * @brief Enumeration of time sources for the host clock.
+ */
+typedef enum {
+    HOST_CLOCK_REALTIME,  // Follows the Linux monotonic clock
+    HOST_CLOCK_VIRTUAL    // Advances only on reads and delays
+} HostClockModes;
+
+/**
+ * @brief Hook called by the host clock as time advances.
+ * @param now_us The current host time in microseconds.
+ */
+typedef void (*HostClockHook)(const uint64_t now_us);
+
+/**
+ * @brief Interrupt handler called by the host clock when an alarm expires.
+ */
+typedef void (*HostClockAlarm)(void);
+
+/**
+ * @brief Sets the time source of the host clock and restarts it from zero.
+ * @param mode The clock mode to use.
+ * @note In virtual mode, every clock read advances time by the configured read
+ * cost so polling loops always make progress, and delays return immediately
+ * after advancing time, so simulations run faster than real time.
+ */
+void set_host_clock_mode(const HostClockModes mode);
+
+/**
+ * @brief Sets the virtual time consumed by each clock read.
+ * @param ns The read cost in nanoseconds.
+ * @note Only used in virtual mode. Smaller values give finer IR discharge
+ * resolution at the cost of more loop iterations per simulated millisecond.
+ */
+void set_host_clock_read_cost(const uint32_t ns);
+
+/**
+ * @brief Registers a hook called every time the clock advances by at least
+ * the given period.
+ * @param hook The hook to call, or NULL to remove it.
+ * @param period_us The minimum interval in microseconds between calls.
+ * @note The hook is not re-entered if it reads the clock itself.
+ */
+void set_host_clock_hook(const HostClockHook hook, const uint32_t period_us);
+
+/**
+ * @brief Arms a one-shot alarm that interrupts the firmware once the clock
+ * reaches the given time.
+ * @param alarm The handler to call, or NULL to disarm the alarm.
+ * @param at_ns The host time in nanoseconds at which the alarm expires.
+ * @note The handler runs from the first clock read or delay step at or past
+ * the expiry, as an interrupt preempting the code that read the clock. It may
+ * re-arm the alarm and is not re-entered while running.
+ */
+void set_host_clock_alarm(const HostClockAlarm alarm, const uint64_t at_ns);
+
+/**
+ * @brief Reads the host clock, charging the read cost in virtual mode.
+ * @return The current host time in nanoseconds.
+ */
+uint64_t read_host_clock_ns(void);
+
+/**
+ * @brief Peeks at the host clock without advancing it.
+ * @return The current host time in nanoseconds.
+ */
+uint64_t peek_host_clock_ns(void);
+
+/**
+ * @brief Returns how many times the clock was read, delay steps included.
+ * @return The number of clock reads since the program started.
+ * @note Lets the simulator tell the firmware's own CPU time from the time
+ * spent polling the clock, which depends on the read cost.
+ */
+uint64_t get_host_clock_reads(void);
+
+/**
+ * @brief Waits for the given duration.
+ * @param ns The duration in nanoseconds.
+ * @note Sleeps in realtime mode and advances time directly in virtual mode.
+ */
+void wait_host_clock_ns(const uint64_t ns);
+
+#endif  // HOST_CLOCK_H
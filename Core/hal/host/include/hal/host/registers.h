@@ -0,0 +1,77 @@
+#ifndef HOST_REGISTERS_H
+#define HOST_REGISTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal/ir_sensors.h"
+
+#define MPU_REGISTER_COUNT 128  // Size of the simulated MPU-9250 register bank
+#define MPU_FIFO_SIZE 512        // Size of the simulated MPU-9250 FIFO
+#define IR_DISCHARGE_NEVER UINT16_MAX  // Discharge time of a fully dark sensor
+
+/**
+ * @struct HostRegisters
+ * @brief Simulated peripheral registers backing the host HAL.
+ * @note Values written by the firmware (PWM, directions, LED) are meant to be
+ * read by a plant model, while the plant writes the sensor side (encoders,
+ * IR discharge times, side sensors and MPU registers).
+ */
+typedef struct {
+    bool tim2_enabled;           // TIM2 PWM counter enabled
+    uint32_t tim2_ccr2;          // TIM2 CH2 compare value (left motor)
+    uint32_t tim2_ccr3;          // TIM2 CH3 compare value (right motor)
+    uint32_t tim2_ccr4;          // TIM2 CH4 compare value (turbine)
+    bool motor_left_forward;     // Left motor H-bridge direction
+    bool motor_right_forward;    // Right motor H-bridge direction
+    bool tim3_enabled;           // TIM3 encoder counter enabled
+    bool tim4_enabled;           // TIM4 encoder counter enabled
+    uint16_t tim3_cnt;           // TIM3 counter (left encoder)
+    uint16_t tim4_cnt;           // TIM4 counter (right encoder)
+    bool ir_emitter_on;          // SENSOR_IR_INPUT output level
+    uint32_t ir_read_count;      // Central sensor reads started
+    bool led_on;                 // Board LED output level
+    uint32_t iwdg_expiries;      // Watchdog refreshes that came too late
+    bool side_sensor_pins[TOTAL_SIDE_SENSORS];  // Side pins, low over a marker
+    uint16_t ir_discharge_us[TOTAL_CENTRAL_SENSORS];  // Central discharge times
+    uint8_t mpu[MPU_REGISTER_COUNT];  // MPU-9250 register bank
+    uint8_t mpu_fifo[MPU_FIFO_SIZE];  // MPU-9250 FIFO ring buffer
+    uint16_t mpu_fifo_head;           // Index of the oldest FIFO byte
+    uint16_t mpu_fifo_count;          // Bytes queued in the FIFO
+    uint64_t mpu_sample_ns;           // Time of the last MPU sample
+} HostRegisters;
+
+/**
+ * @brief Returns the simulated register file used by the host HAL.
+ * @return Pointer to the simulated registers.
+ * @note The register file starts in the power-on state of the robot: motors
+ * stopped, side sensors high, central sensors dark and MPU WHO_AM_I set.
+ */
+HostRegisters* get_host_registers(void);
+
+/**
+ * @brief Resets the simulated registers to their power-on state.
+ */
+void reset_host_registers(void);
+
+/**
+ * @brief Queues the MPU samples taken up to a time into the MPU FIFO.
+ * @param now_ns Current host clock time in nanoseconds.
+ * @note One sample of the enabled registers is queued per sample period
+ * elapsed, with the register values at the time of the call, so the plant
+ * should call it after every update of the MPU registers.
+ */
+void update_host_mpu_fifo(const uint64_t now_ns);
+
+/**
+ * @brief Empties the MPU FIFO.
+ */
+void reset_host_mpu_fifo(void);
+
+/**
+ * @brief Removes the oldest byte from the MPU FIFO.
+ * @return The byte removed, or 0 if the FIFO is empty.
+ */
+uint8_t pop_host_mpu_fifo(void);
+
+#endif  // HOST_REGISTERS_H
@@ -0,0 +1,25 @@
+#ifndef HOST_SERIAL_H
+#define HOST_SERIAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Enables or disables the pseudo-terminal backing USART1.
+ * @param enabled true to open a pty on init_usart(), false to keep the USART
+ * detached.
+ * @note Must be called before init_usart(). The pty is enabled by default and
+ * its slave device path is printed to stderr when opened.
+ */
+void set_host_usart_pty(const bool enabled);
+
+/**
+ * @brief Pushes bytes into the USART receive buffer as if they were received
+ * over the wire.
+ * @param data Pointer to the bytes to inject.
+ * @param size The number of bytes to inject.
+ * @return true if all bytes fit in the receive buffer, false otherwise.
+ */
+bool inject_host_usart_rx(const uint8_t* const data, const uint8_t size);
+
+#endif  // HOST_SERIAL_H
@@ -0,0 +1,127 @@
+#include "hal/host/clock.h"
+
+#include <stdbool.h>
+#include <time.h>
+
+#define NS_PER_US 1000ULL
+#define NS_PER_S 1000000000ULL
+
+static HostClockModes clock_mode = HOST_CLOCK_REALTIME;
+static uint32_t read_cost_ns = HOST_CLOCK_READ_COST_NS;
+
+static uint64_t virtual_ns = 0;
+static uint64_t realtime_origin_ns = 0;
+static uint64_t clock_reads = 0;
+
+static HostClockHook clock_hook = NULL;
+static uint32_t hook_period_us = 0;
+static uint64_t last_hook_us = 0;
+static bool hook_running = false;
+
+static HostClockAlarm clock_alarm = NULL;
+static uint64_t alarm_ns = 0;
+static bool alarm_running = false;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+static void run_hook(const uint64_t now_ns) {
+    if (!clock_hook || hook_running) return;
+
+    const uint64_t now_us = now_ns / NS_PER_US;
+    if (now_us - last_hook_us < hook_period_us) return;
+
+    hook_running = true;
+    last_hook_us = now_us;
+    clock_hook(now_us);
+    hook_running = false;
+}
+
+static void run_alarm(const uint64_t now_ns) {
+    if (!clock_alarm || alarm_running || now_ns < alarm_ns) return;
+
+    const HostClockAlarm alarm = clock_alarm;
+    clock_alarm = NULL;  // One-shot, the handler may re-arm it
+
+    alarm_running = true;
+    alarm();
+    alarm_running = false;
+}
+
+static void run_handlers(const uint64_t now_ns) {
+    run_hook(now_ns);
+    run_alarm(now_ns);
+}
+
+void set_host_clock_mode(const HostClockModes mode) {
+    clock_mode = mode;
+    virtual_ns = 0;
+    realtime_origin_ns = monotonic_ns();
+    last_hook_us = 0;
+    clock_alarm = NULL;
+    alarm_running = false;
+}
+
+void set_host_clock_read_cost(const uint32_t ns) { read_cost_ns = ns; }
+
+void set_host_clock_hook(const HostClockHook hook, const uint32_t period_us) {
+    clock_hook = hook;
+    hook_period_us = period_us;
+    hook_running = false;   // A hook may have left through a longjmp
+    alarm_running = false;  // Possibly from inside an alarm handler
+    last_hook_us = peek_host_clock_ns() / NS_PER_US;
+}
+
+void set_host_clock_alarm(const HostClockAlarm alarm, const uint64_t at_ns) {
+    clock_alarm = alarm;
+    alarm_ns = at_ns;
+}
+
+uint64_t peek_host_clock_ns(void) {
+    if (clock_mode == HOST_CLOCK_VIRTUAL) return virtual_ns;
+    return monotonic_ns() - realtime_origin_ns;
+}
+
+uint64_t get_host_clock_reads(void) { return clock_reads; }
+
+uint64_t read_host_clock_ns(void) {
+    clock_reads++;
+    if (clock_mode == HOST_CLOCK_VIRTUAL) virtual_ns += read_cost_ns;
+
+    const uint64_t now_ns = peek_host_clock_ns();
+    run_handlers(now_ns);
+
+    return now_ns;
+}
+
+void wait_host_clock_ns(const uint64_t ns) {
+    if (clock_mode == HOST_CLOCK_VIRTUAL) {
+        // Step through the wait so the hook keeps its period
+        const uint64_t step_ns =
+            hook_period_us ? hook_period_us * NS_PER_US : ns;
+        const uint64_t end_ns = virtual_ns + ns;
+
+        while (virtual_ns < end_ns) {
+            uint64_t next_ns =
+                end_ns - virtual_ns < step_ns ? end_ns : virtual_ns + step_ns;
+            if (clock_alarm && alarm_ns > virtual_ns && alarm_ns < next_ns) {
+                next_ns = alarm_ns;  // Interrupts fire on time during delays
+            }
+
+            virtual_ns = next_ns;
+            clock_reads++;
+            run_handlers(virtual_ns);
+        }
+        return;
+    }
+
+    const struct timespec ts = {
+        .tv_sec = (time_t)(ns / NS_PER_S),
+        .tv_nsec = (long)(ns % NS_PER_S),
+    };
+    nanosleep(&ts, NULL);
+    run_handlers(peek_host_clock_ns());
+}
@@ -0,0 +1,70 @@
+#include "hal/control_timer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hal/host/clock.h"
+
+#define NS_PER_US 1000ULL
+
+static ControlTimerCallback control_callback = NULL;
+static uint64_t period_ns = 0;
+static uint64_t sample_ns = 0;
+static uint64_t frame_start_ns = 0;
+static bool sample_pending = false;
+static bool masked = false;
+static bool irq_pending = false;
+
+static void handle_alarm(void) {
+    // Re-arm before the callback so its own clock reads can't delay the timer
+    if (sample_pending) {
+        frame_start_ns += period_ns;
+        set_host_clock_alarm(handle_alarm, frame_start_ns);
+    } else {
+        set_host_clock_alarm(handle_alarm, frame_start_ns + sample_ns);
+    }
+
+    sample_pending = !sample_pending;
+    if (masked) {
+        irq_pending = true;
+        return;
+    }
+
+    if (control_callback) control_callback();
+}
+
+void init_control_timer(const uint16_t period_us, const uint16_t sample_us,
+                        const ControlTimerCallback callback) {
+    control_callback = callback;
+    period_ns = period_us * NS_PER_US;
+    sample_ns = sample_us * NS_PER_US;
+}
+
+// Only read when the next sample is armed at the start of a frame
+void set_control_timer_sample(const uint16_t sample_us) {
+    sample_ns = sample_us * NS_PER_US;
+}
+
+void start_control_timer(void) {
+    frame_start_ns = peek_host_clock_ns();
+    sample_pending = false;
+    set_host_clock_alarm(handle_alarm, frame_start_ns);
+}
+
+void stop_control_timer(void) {
+    set_host_clock_alarm(NULL, 0);
+    irq_pending = false;
+}
+
+void mask_control_timer(void) { masked = true; }
+
+void unmask_control_timer(void) {
+    masked = false;
+    if (!irq_pending) return;
+
+    irq_pending = false;
+    if (control_callback) control_callback();
+}
+
+// Timer events are raised by the host clock alarm instead
+void control_timer_irq_handler(void) {}
@@ -0,0 +1,40 @@
+#include "hal/encoders.h"
+
+#include "hal/host/registers.h"
+
+void init_encoder_counters(void) {
+    HostRegisters* const regs = get_host_registers();
+    regs->tim3_enabled = true;
+    regs->tim4_enabled = true;
+}
+
+void set_encoder_left(const int16_t value) {
+    get_host_registers()->tim3_cnt = (uint16_t)value;
+}
+
+void set_encoder_right(const int16_t value) {
+    get_host_registers()->tim4_cnt = (uint16_t)value;
+}
+
+void set_encoder_values(const int16_t left, const int16_t right) {
+    set_encoder_left(left);
+    set_encoder_right(right);
+}
+
+void set_encoders(const int16_t value) {
+    set_encoder_left(value);
+    set_encoder_right(value);
+}
+
+int16_t get_encoder_left(void) {
+    return (int16_t)get_host_registers()->tim3_cnt;
+}
+
+int16_t get_encoder_right(void) {
+    return (int16_t)get_host_registers()->tim4_cnt;
+}
+
+void get_encoder_values(int16_t *left, int16_t *right) {
+    if (left) *left = get_encoder_left();
+    if (right) *right = get_encoder_right();
+}
@@ -0,0 +1,42 @@
+#include "hal/flash.h"
+
+#include <string.h>
+
+static uint32_t store[FLASH_STORE_SECTORS][FLASH_STORE_WORDS];
+static bool store_initialized = false;
+
+// A blank part comes out of the factory erased
+static void init_store(void) {
+    if (store_initialized) return;
+
+    memset(store, 0xFF, sizeof(store));
+    store_initialized = true;
+}
+
+// The host image lives outside the simulated flash
+bool check_flash_store(void) { return true; }
+
+const uint32_t* get_flash_store(const uint8_t sector) {
+    init_store();
+    return store[sector];
+}
+
+bool erase_flash_store(const uint8_t sector) {
+    if (sector >= FLASH_STORE_SECTORS) return false;
+    init_store();
+
+    memset(store[sector], 0xFF, sizeof(store[sector]));
+    return true;
+}
+
+bool program_flash_store(const uint8_t sector, const uint32_t offset,
+                         const uint32_t* const words, const uint16_t count) {
+    if (sector >= FLASH_STORE_SECTORS || offset + count > FLASH_STORE_WORDS) {
+        return false;
+    }
+    init_store();
+
+    // Like NOR flash, programming only clears bits
+    for (uint16_t i = 0; i < count; i++) store[sector][offset + i] &= words[i];
+    return true;
+}
@@ -0,0 +1,159 @@
+#include "hal/ir_sensors.h"
+
+#include <string.h>
+
+#include "hal/host/clock.h"
+#include "hal/host/registers.h"
+#include "timer/time.h"
+
+#define ALL_SENSORS_CAPTURED ((uint8_t)((1U << TOTAL_CENTRAL_SENSORS) - 1))
+#define SIDE_EDGE_MASK (SIDE_EDGE_BUFFER_SIZE - 1)
+#define NS_PER_US 1000ULL
+
+static uint32_t start_time = 0;
+static uint16_t central_sensor_values[TOTAL_CENTRAL_SENSORS] = {0};
+static uint8_t central_sensor_byte = 0;
+static bool central_sensor_reading_started = false;
+
+static SideSensorEdge side_edges[SIDE_EDGE_BUFFER_SIZE];
+static uint8_t side_edges_head = 0;
+static uint8_t side_edges_tail = 0;
+static uint8_t side_state = 0;  // Bit i set over a marker
+
+// Stands in for the EXTI handler, stamping each discharge at its exact time
+static void capture_discharges(const uint32_t read_interval) {
+    const HostRegisters* const regs = get_host_registers();
+    if (!central_sensor_reading_started || !regs->ir_emitter_on) return;
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (!(central_sensor_byte & (1 << i)) &&
+            regs->ir_discharge_us[i] <= read_interval) {
+            central_sensor_values[i] = regs->ir_discharge_us[i];
+            central_sensor_byte |= (1 << i);
+        }
+    }
+}
+
+static uint8_t sample_side_sensors(void) {
+    const HostRegisters* const regs = get_host_registers();
+    uint8_t state = 0;
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        if (!regs->side_sensor_pins[i]) state |= 1 << i;
+    }
+
+    return state;
+}
+
+static void push_side_edge(const uint8_t sensor, const bool active,
+                           const uint32_t time) {
+    const uint8_t next = (side_edges_head + 1) & SIDE_EDGE_MASK;
+    if (next == side_edges_tail) return;
+
+    side_edges[side_edges_head] =
+        (SideSensorEdge){.sensor = sensor, .active = active, .time_us = time};
+    side_edges_head = next;
+}
+
+static void fill_missing_values(const uint16_t timeout) {
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (!(central_sensor_byte & (1 << i))) {
+            central_sensor_values[i] = timeout;
+        }
+    }
+}
+
+void init_ir_capture(void) {}
+
+void ir_capture_irq_handler(void) {
+    capture_discharges(time_us() - start_time);
+}
+
+void start_read(void) {
+    HostRegisters* const regs = get_host_registers();
+    regs->ir_emitter_on = true;
+    regs->ir_read_count++;
+    memset(central_sensor_values, 0, sizeof(central_sensor_values));
+    central_sensor_byte = 0;
+    start_time = time_us();
+    central_sensor_reading_started = true;
+}
+
+void stop_read(void) {
+    get_host_registers()->ir_emitter_on = false;
+    central_sensor_reading_started = false;
+}
+
+uint8_t read_central_sensors(const uint16_t timeout) {
+    start_read();
+
+    while (central_sensor_is_reading(timeout)) {
+    }
+
+    fill_missing_values(timeout);
+    stop_read();
+
+    return central_sensor_byte;
+}
+
+const uint16_t* get_central_sensor_values(void) {
+    return central_sensor_values;
+}
+
+bool central_sensor_is_reading(const uint16_t timeout) {
+    if (!central_sensor_reading_started) return false;
+
+    const uint32_t read_interval = time_us() - start_time;
+    capture_discharges(read_interval);
+
+    return (central_sensor_byte != ALL_SENSORS_CAPTURED &&
+            read_interval < timeout);
+}
+
+uint8_t read_central_sensors_async(void) {
+    const uint32_t read_interval = time_us() - start_time;
+    capture_discharges(read_interval);
+    fill_missing_values(read_interval < UINT16_MAX ? read_interval
+                                                   : UINT16_MAX);
+
+    return central_sensor_byte;
+}
+
+const bool* get_side_sensor_values(void) {
+    static bool side_sensor_values[TOTAL_SIDE_SENSORS] = {0};
+    const HostRegisters* const regs = get_host_registers();
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        side_sensor_values[i] = !regs->side_sensor_pins[i];
+    }
+
+    return side_sensor_values;
+}
+
+void init_side_capture(void) { side_state = sample_side_sensors(); }
+
+// Run by the plant after moving the side pins, as the sampling timer would
+void side_capture_irq_handler(void) {
+    const uint8_t state = sample_side_sensors();
+    const uint8_t changed = state ^ side_state;
+    if (!changed) return;
+
+    // Peeking keeps the clock still, unlike a firmware clock read
+    const uint32_t now = (uint32_t)(peek_host_clock_ns() / NS_PER_US);
+    side_state = state;
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        if (changed & (1 << i)) push_side_edge(i, state & (1 << i), now);
+    }
+}
+
+void clear_side_edges(void) { side_edges_tail = side_edges_head; }
+
+bool read_side_edge(SideSensorEdge* const edge) {
+    if (side_edges_tail == side_edges_head) return false;
+
+    *edge = side_edges[side_edges_tail];
+    side_edges_tail = (side_edges_tail + 1) & SIDE_EDGE_MASK;
+
+    return true;
+}
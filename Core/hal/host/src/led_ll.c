@@ -0,0 +1,12 @@
+#include "hal/led_ll.h"
+
+#include "hal/host/registers.h"
+
+void board_led_on(void) { get_host_registers()->led_on = true; }
+
+void board_led_off(void) { get_host_registers()->led_on = false; }
+
+void board_led_toggle(void) {
+    HostRegisters* const regs = get_host_registers();
+    regs->led_on = !regs->led_on;
+}
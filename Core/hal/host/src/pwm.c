@@ -0,0 +1,51 @@
+#include "hal/pwm.h"
+
+#include "hal/host/registers.h"
+
+void init_pwm(void) { get_host_registers()->tim2_enabled = true; }
+
+void set_pwm(const Motors motor, uint32_t pwm) {
+    HostRegisters* const regs = get_host_registers();
+
+    if (pwm > MAX_PWM) pwm = MAX_PWM;
+#if MIN_PWM > 0
+    if (pwm < MIN_PWM) pwm = MIN_PWM;
+#endif
+
+    switch (motor) {
+        case MOTOR_LEFT:
+            regs->tim2_ccr2 = pwm;
+            break;
+        case MOTOR_RIGHT:
+            regs->tim2_ccr3 = pwm;
+            break;
+        case MOTOR_TURBINE:
+            regs->tim2_ccr4 = pwm;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t get_pwm(const Motors motor) {
+    const HostRegisters* const regs = get_host_registers();
+
+    switch (motor) {
+        case MOTOR_LEFT:
+            return regs->tim2_ccr2;
+        case MOTOR_RIGHT:
+            return regs->tim2_ccr3;
+        case MOTOR_TURBINE:
+            return regs->tim2_ccr4;
+        default:
+            return 0;
+    }
+}
+
+void set_motor_left_dir(const bool forward) {
+    get_host_registers()->motor_left_forward = forward;
+}
+
+void set_motor_right_dir(const bool forward) {
+    get_host_registers()->motor_right_forward = forward;
+}
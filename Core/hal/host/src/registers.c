@@ -0,0 +1,113 @@
+#include "hal/host/registers.h"
+
+#include <string.h>
+
+#define MPU_REG_WHO_AM_I 0x75
+#define MPU_WHO_AM_I_9250_A 0x71
+#define MPU_REG_CONFIG 0x1A
+#define MPU_REG_FIFO_EN 0x23
+#define MPU_REG_USER_CTRL 0x6A
+#define MPU_REG_FIFO_COUNT 0x72
+#define MPU_REG_DATA 0x3B  // First sample register, accelerometer X
+
+#define MPU_FIFO_MODE 0x40      // CONFIG: stop writing once the FIFO is full
+#define MPU_FIFO_ENABLE 0x40    // USER_CTRL: FIFO enabled
+#define MPU_SAMPLE_WORDS 7      // Accel XYZ, temperature and gyro XYZ
+#define MPU_SAMPLE_PERIOD_NS 1000000ULL  // 1 kHz sample rate
+
+// FIFO_EN bit enabling each word of a sample, in register order
+static const uint8_t sample_word_enables[MPU_SAMPLE_WORDS] = {
+    0x08, 0x08, 0x08, 0x80, 0x40, 0x20, 0x10};
+
+static HostRegisters registers;
+static bool registers_initialized = false;
+
+HostRegisters* get_host_registers(void) {
+    if (!registers_initialized) reset_host_registers();
+    return &registers;
+}
+
+void reset_host_registers(void) {
+    memset(&registers, 0, sizeof(registers));
+
+    registers.motor_left_forward = true;
+    registers.motor_right_forward = true;
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        registers.side_sensor_pins[i] = true;
+    }
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        registers.ir_discharge_us[i] = IR_DISCHARGE_NEVER;
+    }
+
+    registers.mpu[MPU_REG_WHO_AM_I] = MPU_WHO_AM_I_9250_A;
+    registers_initialized = true;
+}
+
+static void update_fifo_count(void) {
+    registers.mpu[MPU_REG_FIFO_COUNT] = registers.mpu_fifo_count >> 8;
+    registers.mpu[MPU_REG_FIFO_COUNT + 1] = registers.mpu_fifo_count & 0xFF;
+}
+
+static void push_fifo(const uint8_t value) {
+    if (registers.mpu_fifo_count == MPU_FIFO_SIZE) {
+        if (registers.mpu[MPU_REG_CONFIG] & MPU_FIFO_MODE) return;
+
+        // Overwrites the oldest byte otherwise
+        (void)pop_host_mpu_fifo();
+    }
+
+    const uint16_t tail =
+        (registers.mpu_fifo_head + registers.mpu_fifo_count) % MPU_FIFO_SIZE;
+    registers.mpu_fifo[tail] = value;
+    registers.mpu_fifo_count++;
+}
+
+static void push_sample(void) {
+    const uint8_t enables = registers.mpu[MPU_REG_FIFO_EN];
+
+    for (uint8_t i = 0; i < MPU_SAMPLE_WORDS; i++) {
+        if (!(enables & sample_word_enables[i])) continue;
+
+        push_fifo(registers.mpu[MPU_REG_DATA + 2 * i]);
+        push_fifo(registers.mpu[MPU_REG_DATA + 2 * i + 1]);
+    }
+}
+
+void update_host_mpu_fifo(const uint64_t now_ns) {
+    HostRegisters* const regs = get_host_registers();
+
+    // Samples past the FIFO size would only overwrite identical ones
+    const uint64_t max_behind_ns = MPU_FIFO_SIZE * MPU_SAMPLE_PERIOD_NS;
+    if (now_ns - regs->mpu_sample_ns > max_behind_ns) {
+        regs->mpu_sample_ns = now_ns - max_behind_ns;
+    }
+
+    while (now_ns - regs->mpu_sample_ns >= MPU_SAMPLE_PERIOD_NS) {
+        regs->mpu_sample_ns += MPU_SAMPLE_PERIOD_NS;
+        if (regs->mpu[MPU_REG_USER_CTRL] & MPU_FIFO_ENABLE) push_sample();
+    }
+
+    update_fifo_count();
+}
+
+void reset_host_mpu_fifo(void) {
+    HostRegisters* const regs = get_host_registers();
+
+    regs->mpu_fifo_head = 0;
+    regs->mpu_fifo_count = 0;
+    update_fifo_count();
+}
+
+uint8_t pop_host_mpu_fifo(void) {
+    HostRegisters* const regs = get_host_registers();
+    if (regs->mpu_fifo_count == 0) return 0;
+
+    const uint8_t value = regs->mpu_fifo[regs->mpu_fifo_head];
+    regs->mpu_fifo_head = (regs->mpu_fifo_head + 1) % MPU_FIFO_SIZE;
+    regs->mpu_fifo_count--;
+    update_fifo_count();
+
+    return value;
+}
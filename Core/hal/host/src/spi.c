@@ -0,0 +1,126 @@
+#include "hal/spi.h"
+
+#include <stddef.h>
+
+#include "hal/host/clock.h"
+#include "hal/host/registers.h"
+#include "timer/time.h"
+
+#define MPU_REG_PWR_MGMT_1 0x6B
+#define MPU_REG_WHO_AM_I 0x75
+#define MPU_REG_CONFIG 0x1A
+#define MPU_ACCEL_CONFIG 0x1C
+#define MPU_ACCEL_CONFIG2 0x1D
+#define MPU_GYRO_CONFIG 0x1B
+#define MPU_REG_SMPLRT_DIV 0x19
+#define MPU_REG_FIFO_EN 0x23
+#define MPU_REG_USER_CTRL 0x6A
+
+#define START_COMMAND 0x80
+#define CLOCK_SRC 0x01
+#define DLPF_CONFIG 0x01        // ~184Hz
+#define DLPF_ACCEL_CONFIG 0x01  // ~184Hz
+#define ACCEL_CONFIG 0x00       // +/- 2g
+#define GYRO_CONFIG 0x18        // +/- 2000 deg/s
+#define FIFO_MODE 0x40          // Stop writing when the FIFO is full
+#define FIFO_SENSORS 0xF8       // Temperature, gyro XYZ and accel XYZ
+#define FIFO_ENABLE 0x40
+#define FIFO_RESET 0x04
+
+#define MPU_WHO_AM_I_9250_A 0x71
+#define MPU_WHO_AM_I_9250_B 0x73
+
+#define SPI_READ_BUFFERS 2  // Half parsed by the callback, half being filled
+
+static SpiReadCallback read_callback = NULL;
+static uint8_t rx_buffers[SPI_READ_BUFFERS][SPI_MAX_READ] = {{0}};
+static uint8_t back_buffer = 0;
+
+static void mpu_write_register(const uint8_t reg, const uint8_t value) {
+    HostRegisters* const regs = get_host_registers();
+    const uint8_t address = (reg & 0x7F) % MPU_REGISTER_COUNT;
+
+    // Device reset bit self-clears
+    if (address == MPU_REG_PWR_MGMT_1 && (value & START_COMMAND)) {
+        regs->mpu[address] = 0x00;
+        return;
+    }
+
+    // FIFO reset bit self-clears
+    if (address == MPU_REG_USER_CTRL && (value & FIFO_RESET)) {
+        reset_host_mpu_fifo();
+        regs->mpu[address] = value & ~FIFO_RESET;
+        return;
+    }
+
+    regs->mpu[address] = value;
+}
+
+static uint8_t mpu_read_register(const uint8_t reg) {
+    return get_host_registers()->mpu[(reg & 0x7F) % MPU_REGISTER_COUNT];
+}
+
+static bool check_who_am_i(void) {
+    const uint8_t who_am_i = mpu_read_register(MPU_REG_WHO_AM_I);
+    return (who_am_i == MPU_WHO_AM_I_9250_A || who_am_i == MPU_WHO_AM_I_9250_B);
+}
+
+bool init_spi(void) {
+    mpu_write_register(MPU_REG_PWR_MGMT_1, START_COMMAND);
+    delay(100);
+
+    mpu_write_register(MPU_REG_PWR_MGMT_1, CLOCK_SRC);
+    mpu_write_register(MPU_ACCEL_CONFIG, ACCEL_CONFIG);
+    mpu_write_register(MPU_GYRO_CONFIG, GYRO_CONFIG);
+
+    mpu_write_register(MPU_REG_SMPLRT_DIV, 0x00);
+    mpu_write_register(MPU_ACCEL_CONFIG2, DLPF_ACCEL_CONFIG);
+    mpu_write_register(MPU_REG_CONFIG, FIFO_MODE | DLPF_CONFIG);
+
+    mpu_write_register(MPU_REG_FIFO_EN, FIFO_SENSORS);
+    mpu_write_register(MPU_REG_USER_CTRL, FIFO_ENABLE | FIFO_RESET);
+
+    for (uint8_t i = 0; i < 5; i++) {
+        if (!check_who_am_i()) return false;
+        delay(10);
+    }
+
+    return check_who_am_i();
+}
+
+void read_registers(const uint8_t reg, uint8_t* buffer, const uint8_t bytes) {
+    // Catch the FIFO up with the samples taken since the plant last did
+    if (reg == FIFO_COUNT_REG) update_host_mpu_fifo(peek_host_clock_ns());
+
+    // Burst reads auto-increment, except on the FIFO port that they drain
+    for (uint8_t i = 0; i < bytes; i++) {
+        buffer[i] =
+            reg == FIFO_REG ? pop_host_mpu_fifo() : mpu_read_register(reg + i);
+    }
+}
+
+void reset_fifo(void) {
+    mpu_write_register(MPU_REG_USER_CTRL, FIFO_ENABLE | FIFO_RESET);
+}
+
+void init_spi_dma(const SpiReadCallback callback) { read_callback = callback; }
+
+bool start_registers_read(const uint8_t reg, const uint8_t bytes) {
+    if (bytes > SPI_MAX_READ) return false;
+
+    // The transfer completes at once, so the callback runs from the caller
+    uint8_t* const data = rx_buffers[back_buffer];
+    read_registers(reg, data, bytes);
+    back_buffer = (back_buffer + 1) % SPI_READ_BUFFERS;
+
+    if (read_callback) read_callback(data);
+    return true;
+}
+
+void mask_spi_dma(void) {
+    // The callback only runs from start_registers_read(), nothing to hold
+}
+
+void unmask_spi_dma(void) {}
+
+void spi_dma_irq_handler(void) {}
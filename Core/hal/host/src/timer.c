@@ -0,0 +1,27 @@
+#include "hal/timer.h"
+
+#include "hal/host/clock.h"
+
+#define NS_PER_US 1000ULL
+#define NS_PER_MS 1000000ULL
+
+void init_system_timer(void) {}
+
+uint32_t get_system_time(void) {
+    return (uint32_t)(read_host_clock_ns() / NS_PER_MS);
+}
+
+uint32_t get_system_time_us(void) {
+    return (uint32_t)(read_host_clock_ns() / NS_PER_US);
+}
+
+uint64_t get_system_time_us64(void) { return read_host_clock_ns() / NS_PER_US; }
+
+// Overflows never happen on the 64-bit host clock
+void timebase_irq_handler(void) {}
+
+bool time_elapsed_ms(const uint32_t start, const uint32_t duration) {
+    return (get_system_time() - start) >= duration;
+}
+
+void delay_ms(const uint32_t ms) { wait_host_clock_ns(ms * NS_PER_MS); }
@@ -0,0 +1,139 @@
+#define _GNU_SOURCE
+
+#include "hal/usart.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "hal/host/serial.h"
+
+#define TX_BUFFER_SIZE 256
+#define RX_BUFFER_SIZE 256
+
+static uint8_t rx_buf[RX_BUFFER_SIZE];
+static uint8_t rx_head = 0;
+static uint8_t rx_tail = 0;
+
+static bool pty_enabled = true;
+static int pty_master = -1;
+static int pty_slave = -1;
+
+static inline uint8_t next_rx_index(const uint8_t index) {
+    return (index + 1) & (RX_BUFFER_SIZE - 1);
+}
+
+static bool push_rx_byte(const uint8_t data) {
+    const uint8_t next_head = next_rx_index(rx_head);
+    if (next_head == rx_tail) return false;  // Buffer full, discard data
+
+    rx_buf[rx_head] = data;
+    rx_head = next_head;
+    return true;
+}
+
+static bool open_pty(void) {
+    pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty_master < 0) return false;
+
+    if (grantpt(pty_master) != 0 || unlockpt(pty_master) != 0) {
+        close(pty_master);
+        pty_master = -1;
+        return false;
+    }
+
+    const char* const slave_name = ptsname(pty_master);
+
+    // Keep the slave open in raw mode so writes never echo or fail with EIO
+    pty_slave = open(slave_name, O_RDWR | O_NOCTTY);
+    if (pty_slave >= 0) {
+        struct termios tio;
+        tcgetattr(pty_slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(pty_slave, TCSANOW, &tio);
+    }
+
+    fcntl(pty_master, F_SETFL, fcntl(pty_master, F_GETFL) | O_NONBLOCK);
+    fprintf(stderr, "USART1 attached to %s\n", slave_name);
+    return true;
+}
+
+void set_host_usart_pty(const bool enabled) { pty_enabled = enabled; }
+
+bool inject_host_usart_rx(const uint8_t* const data, const uint8_t size) {
+    for (uint8_t i = 0; i < size; i++) {
+        if (!push_rx_byte(data[i])) return false;
+    }
+
+    return true;
+}
+
+void init_usart(void) {
+    if (pty_enabled && pty_master < 0 && !open_pty()) {
+        fprintf(stderr, "USART1 pty unavailable, running detached\n");
+    }
+}
+
+void usart1_irq_handler(void) {
+    if (pty_master < 0) return;
+
+    uint8_t chunk[RX_BUFFER_SIZE];
+    const ssize_t count = read(pty_master, chunk, sizeof(chunk));
+
+    for (ssize_t i = 0; i < count; i++) {
+        if (!push_rx_byte(chunk[i])) break;
+    }
+}
+
+void usart_transmit(const uint8_t data) {
+    if (pty_master < 0) return;
+
+    // Drop data nobody is reading instead of blocking the control loop
+    if (write(pty_master, &data, 1) < 0 && errno != EAGAIN) {
+        close(pty_master);
+        pty_master = -1;
+    }
+}
+
+uint8_t usart_read_char(void) {
+    if (rx_head == rx_tail) return 0;
+
+    const uint8_t data = rx_buf[rx_tail];
+    rx_tail = next_rx_index(rx_tail);
+    return data;
+}
+
+uint8_t usart_peek_char(void) {
+    if (rx_head == rx_tail) return 0;
+    return rx_buf[rx_tail];
+}
+
+void usart_read_buffer(uint8_t* buffer, uint8_t size) {
+    const uint8_t data_size =
+        (rx_head - rx_tail + RX_BUFFER_SIZE) & (RX_BUFFER_SIZE - 1);
+
+    if (size > data_size || size == 0) size = data_size;
+
+    for (uint8_t i = 0; i < size; i++) {
+        buffer[i] = rx_buf[rx_tail];
+        rx_tail = next_rx_index(rx_tail);
+    }
+}
+
+uint8_t usart_data_available(void) {
+    usart1_irq_handler();
+    return (rx_head - rx_tail + RX_BUFFER_SIZE) & (RX_BUFFER_SIZE - 1);
+}
+
+bool usart_data_received(void) {
+    usart1_irq_handler();
+    return rx_head != rx_tail;
+}
+
+void usart_flush_rx(void) {
+    rx_head = 0;
+    rx_tail = 0;
+}
@@ -0,0 +1,41 @@
+#include "hal/watchdog.h"
+
+#include "hal/host/clock.h"
+#include "hal/host/registers.h"
+
+#define NS_PER_MS 1000000ULL
+
+static uint64_t timeout_ns = 0;
+static uint64_t last_feed_ns = 0;
+static bool keepalive = true;
+
+// Without SysTick, a late refresh is only noticed once the next one arrives
+static void check_expiry(void) {
+    if (!timeout_ns || keepalive) return;
+
+    if (peek_host_clock_ns() - last_feed_ns > timeout_ns) {
+        get_host_registers()->iwdg_expiries++;
+    }
+}
+
+void init_watchdog(const uint16_t timeout_ms) {
+    timeout_ns = timeout_ms * NS_PER_MS;
+    last_feed_ns = peek_host_clock_ns();
+    keepalive = true;
+}
+
+void feed_watchdog(void) {
+    check_expiry();
+    last_feed_ns = peek_host_clock_ns();
+}
+
+void set_watchdog_keepalive(const bool enabled) {
+    check_expiry();
+    last_feed_ns = peek_host_clock_ns();
+    keepalive = enabled;
+}
+
+bool watchdog_caused_reset(void) { return false; }
+
+// SysTick refreshes are implied by the keepalive flag instead
+void watchdog_tick_handler(void) {}
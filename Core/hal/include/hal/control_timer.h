@@ -0,0 +1,62 @@
+#ifndef HAL_CONTROL_TIMER_H
+#define HAL_CONTROL_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Callback run from the control timer interrupt.
+ */
+typedef void (*ControlTimerCallback)(void);
+
+/**
+ * @brief Configures the hardware timer driving the inner control loop.
+ * @param period_us The interval between control frames in microseconds.
+ * @param sample_us The offset from the start of each frame at which the
+ * callback is run a second time, in microseconds.
+ * @param callback The function called at the start of each frame and again at
+ * the sample offset.
+ * @note The second call lets a frame start a sensor read and collect it once
+ * the read has settled, without waiting inside the interrupt.
+ * @note The timer is left stopped; use start_control_timer() to enable it.
+ */
+void init_control_timer(const uint16_t period_us, const uint16_t sample_us,
+                        const ControlTimerCallback callback);
+
+/**
+ * @brief Moves the offset at which the callback runs a second time.
+ * @param sample_us The new offset from the start of each frame in
+ * microseconds, below the period.
+ * @note Takes effect from the next frame, so the current one is still
+ * sampled once.
+ */
+void set_control_timer_sample(const uint16_t sample_us);
+
+/**
+ * @brief Starts the control timer from the beginning of a frame.
+ */
+void start_control_timer(void);
+
+/**
+ * @brief Stops the control timer and discards any pending interrupt.
+ */
+void stop_control_timer(void);
+
+/**
+ * @brief Holds the control timer interrupt back until unmask_control_timer().
+ * @note Events raised while masked stay pending and run once unmasked, so
+ * foreground code can share data with the callback without tearing it.
+ */
+void mask_control_timer(void);
+
+/**
+ * @brief Lets the control timer interrupt run again after
+ * mask_control_timer().
+ */
+void unmask_control_timer(void);
+
+/**
+ * @brief Handler for the control timer interrupt.
+ */
+void control_timer_irq_handler(void);
+
+#endif  // HAL_CONTROL_TIMER_H
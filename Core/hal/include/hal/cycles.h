@@ -0,0 +1,25 @@
+#ifndef HAL_CYCLES_H
+#define HAL_CYCLES_H
+
+#include <stdint.h>
+
+/**
+ * @brief Enables the DWT cycle counter.
+ */
+void init_cycle_counter(void);
+
+/**
+ * @brief Returns the current value of the cycle counter.
+ * @return The number of core clock cycles since the counter was enabled.
+ * @note Overflows every 2^32 cycles (~42.9 s at 100 MHz), so only differences
+ * between two reads are meaningful.
+ */
+uint32_t get_cycle_count(void);
+
+/**
+ * @brief Returns the frequency the cycle counter runs at.
+ * @return The cycle counter frequency in Hz.
+ */
+uint32_t get_cycle_frequency(void);
+
+#endif  // HAL_CYCLES_H
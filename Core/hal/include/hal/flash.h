@@ -0,0 +1,49 @@
+#ifndef HAL_FLASH_H
+#define HAL_FLASH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FLASH_STORE_SECTORS 2U  // One holds the records, the other is spare
+#define FLASH_STORE_SIZE (128U * 1024U)  // Reserved sector size in bytes
+#define FLASH_STORE_WORDS (FLASH_STORE_SIZE / 4U)
+#define FLASH_ERASED_WORD 0xFFFFFFFFUL
+#define FLASH_ERASE_TIMEOUT_MS 4000  // Worst sector erase is 2 s
+
+/**
+ * @brief Checks that the firmware image ends before the reserved sectors.
+ * @return true if the reserved sectors are free, false if the image reaches
+ * into them.
+ * @note Erasing a sector the image reaches into would erase the firmware.
+ */
+bool check_flash_store(void);
+
+/**
+ * @brief Returns a reserved flash sector, mapped for reading.
+ * @param sector Index of the reserved sector, below FLASH_STORE_SECTORS.
+ * @return Pointer to the first word of the sector.
+ */
+const uint32_t* get_flash_store(const uint8_t sector);
+
+/**
+ * @brief Erases a reserved flash sector, setting every bit.
+ * @param sector Index of the reserved sector, below FLASH_STORE_SECTORS.
+ * @return true if the erase succeeded, false otherwise.
+ * @note Every fetch from flash stalls until the erase is done, interrupts
+ * included, so the watchdog must allow for FLASH_ERASE_TIMEOUT_MS.
+ */
+bool erase_flash_store(const uint8_t sector);
+
+/**
+ * @brief Programs words into a reserved flash sector.
+ * @param sector Index of the reserved sector, below FLASH_STORE_SECTORS.
+ * @param offset Index of the first word to program.
+ * @param words Words to program.
+ * @param count Number of words to program.
+ * @return true if every word was programmed, false otherwise.
+ * @note Programming can only clear bits, so the words should still be erased.
+ */
+bool program_flash_store(const uint8_t sector, const uint32_t offset,
+                         const uint32_t* const words, const uint16_t count);
+
+#endif  // HAL_FLASH_H
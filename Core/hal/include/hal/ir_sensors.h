@@ -4,11 +4,42 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#define TOTAL_CENTRAL_SENSORS 8  // Total number of central sensors
-#define TOTAL_SIDE_SENSORS 2     // Total number of side sensors
+#define TOTAL_CENTRAL_SENSORS 8   // Total number of central sensors
+#define TOTAL_SIDE_SENSORS 2      // Total number of side sensors
+#define LEFT_SIDE_SENSOR 0        // Index of the left side sensor
+#define RIGHT_SIDE_SENSOR 1       // Index of the right side sensor
+#define SIDE_EDGE_BUFFER_SIZE 16  // Side sensor edges kept until read
+
+/**
+ * @struct SideSensorEdge
+ * @brief Structure to hold a state change of a side sensor.
+ */
+typedef struct {
+    uint8_t sensor;    // LEFT_SIDE_SENSOR or RIGHT_SIDE_SENSOR
+    bool active;       // true when the sensor got over a marker
+    uint32_t time_us;  // Time of the sample that saw the change in us
+} SideSensorEdge;
+
+/**
+ * @brief Route the central sensor pins to falling-edge EXTI lines.
+ *
+ * @note Each read then gets its discharge times stamped by
+ * ir_capture_irq_handler() instead of polling the pins.
+ */
+void init_ir_capture(void);
+
+/**
+ * @brief Stamp the central sensors whose capacitors just discharged.
+ *
+ * @note Called from the EXTI interrupts of the central sensor pins.
+ */
+void ir_capture_irq_handler(void);
 
 /**
  * @brief Start the sensor reading process.
+ *
+ * @note Opens a capture window: each sensor's first falling edge stores its
+ * discharge time in the central sensor values.
  */
 void start_read(void);
 
@@ -22,8 +53,8 @@ void stop_read(void);
  *
  * @param timeout Timeout in microseconds for reading the sensors.
  * @return uint8_t A byte representing the state of the central sensors.
- * @note This function blocks until the reading is complete or the timeout is
- * reached.
+ * @note This function blocks until every sensor discharged or the timeout is
+ * reached. The discharge times themselves are captured by interrupts.
  */
 uint8_t read_central_sensors(const uint16_t timeout);
 
@@ -44,6 +75,7 @@ const uint16_t* get_central_sensor_values(void);
  * @param timeout Timeout in microseconds for reading the sensors.
  * @return true if the sensors are being read, false otherwise.
  * @note This function is meant to enable non-blocking sensor reading.
+ * @note The reading ends early once every sensor has discharged.
  */
 bool central_sensor_is_reading(const uint16_t timeout);
 
@@ -52,6 +84,8 @@ bool central_sensor_is_reading(const uint16_t timeout);
  *
  * @return uint8_t A byte representing the state of the central sensors.
  * @note This function does not block and returns the current sensor states.
+ * @note This function closes the capture window; sensors that did not
+ * discharge get the elapsed read time as their value.
  * @note This function should be called after start_read() and before
  * stop_read().
  * @note This function should be used in combination with
@@ -67,4 +101,32 @@ uint8_t read_central_sensors_async(void);
  */
 const bool* get_side_sensor_values(void);
 
+/**
+ * @brief Start sampling the side sensors for edges from a timer interrupt.
+ *
+ * @note EXTI lines 4 and 5 already serve central sensors, so the side pins
+ * are sampled every 50 us by side_capture_irq_handler() instead.
+ */
+void init_side_capture(void);
+
+/**
+ * @brief Record the side sensors that changed since the last sample.
+ */
+void side_capture_irq_handler(void);
+
+/**
+ * @brief Drop the recorded side sensor edges.
+ */
+void clear_side_edges(void);
+
+/**
+ * @brief Pop the oldest recorded side sensor edge.
+ *
+ * @param edge Where to store the edge.
+ * @return true if an edge was popped, false if there were none.
+ * @note Once SIDE_EDGE_BUFFER_SIZE - 1 edges are pending, newer edges are
+ * dropped until some are read.
+ */
+bool read_side_edge(SideSensorEdge* const edge);
+
 #endif  // IR_SENSORS_H
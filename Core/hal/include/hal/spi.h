@@ -14,6 +14,19 @@
 
 #define TOTAL_REGISTERS 14  // Total registers to read for accel, temp, gyro
 
+#define FIFO_SIZE 512        // Bytes the MPU FIFO holds
+#define FIFO_COUNT_REG 0x72  // FIFO byte count, high byte first
+#define FIFO_REG 0x74        // FIFO read port, burst reads drain the FIFO
+#define FIFO_SAMPLE_SIZE TOTAL_REGISTERS  // Same layout as the data registers
+#define FIFO_MAX_BATCH 4                  // Samples drained in one burst
+#define SPI_MAX_READ (FIFO_SAMPLE_SIZE * FIFO_MAX_BATCH)  // Longest DMA read
+
+/**
+ * @brief Callback run once a DMA register read has completed.
+ * @param data Pointer to the bytes read, starting at the requested register.
+ */
+typedef void (*SpiReadCallback)(const uint8_t* data);
+
 /**
  * @brief Initialize the SPI peripheral.
  * @return true if initialization was successful, false otherwise.
@@ -31,4 +44,46 @@ bool init_spi(void);
  */
 void read_registers(const uint8_t reg, uint8_t* buffer, const uint8_t bytes);
 
+/**
+ * @brief Configure the DMA streams used for non-blocking register reads.
+ * @param callback The function called with each completed read.
+ */
+void init_spi_dma(const SpiReadCallback callback);
+
+/**
+ * @brief Empty the MPU FIFO, discarding the samples queued in it.
+ * @note The FIFO stops taking samples once full, so it must be emptied after
+ * it was left undrained to keep the samples aligned.
+ */
+void reset_fifo(void);
+
+/**
+ * @brief Start a DMA burst read of up to SPI_MAX_READ bytes.
+ * @param reg The starting register address to read from.
+ * @param bytes The number of bytes to read.
+ * @return true if the read was started, false if one is still in progress.
+ * @note The bytes land in one half of a double buffer, and the callback runs
+ * from the DMA interrupt with that half, so the next read never overwrites
+ * the data being parsed.
+ */
+bool start_registers_read(const uint8_t reg, const uint8_t bytes);
+
+/**
+ * @brief Holds the DMA completion interrupt back until unmask_spi_dma().
+ * @note Lets foreground code copy data written by the callback without
+ * tearing it.
+ */
+void mask_spi_dma(void);
+
+/**
+ * @brief Releases the DMA completion interrupt held by mask_spi_dma().
+ */
+void unmask_spi_dma(void);
+
+/**
+ * @brief Completes a DMA register read and runs the read callback.
+ * @note Must be called from the SPI2 RX DMA stream interrupt.
+ */
+void spi_dma_irq_handler(void);
+
 #endif  // HAL_SPI_H
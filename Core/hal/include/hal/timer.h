@@ -5,7 +5,9 @@
 #include <stdint.h>
 
 /**
- * @brief Initializes the system timer.
+ * @brief Initializes the system timer and the microsecond timebase.
+ * @note The millisecond time is kept by SysTick, while the microsecond time is
+ * read from the free-running 32-bit TIM5 counter at 1 MHz.
  */
 void init_system_timer(void);
 
@@ -21,10 +23,27 @@ uint32_t get_system_time(void);
  * @brief Returns the current system time in microseconds.
  *
  * @return The current system time in microseconds.
+ * @note This is a single read of the timebase counter, so it is cheap enough
+ * for polling loops and safe to call from any interrupt.
  * @warning This function may overflow after approximately 71.5 minutes.
  */
 uint32_t get_system_time_us(void);
 
+/**
+ * @brief Returns the current monotonic system time in microseconds.
+ *
+ * @return The current system time in microseconds since startup.
+ * @note The timebase counter is extended by counting its overflows, so this
+ * never wraps in practice and is safe to call from any interrupt. Interrupts
+ * are masked for the few cycles it takes to sample the timebase.
+ */
+uint64_t get_system_time_us64(void);
+
+/**
+ * @brief Handles the timebase overflow interrupt.
+ */
+void timebase_irq_handler(void);
+
 /**
  * @brief Checks if a specified duration has elapsed since a given start time.
  *
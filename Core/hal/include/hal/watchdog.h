@@ -0,0 +1,41 @@
+#ifndef HAL_WATCHDOG_H
+#define HAL_WATCHDOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Starts the independent watchdog (IWDG).
+ * @param timeout_ms The time without a refresh after which the MCU is reset,
+ * in milliseconds (1 - 4095).
+ * @note The watchdog can't be stopped once started. It starts with keepalive
+ * enabled, so it is refreshed by SysTick until set_watchdog_keepalive() hands
+ * the refreshes over to the caller.
+ */
+void init_watchdog(const uint16_t timeout_ms);
+
+/**
+ * @brief Refreshes the watchdog counter.
+ */
+void feed_watchdog(void);
+
+/**
+ * @brief Enables or disables refreshing the watchdog from SysTick.
+ * @param enabled true to refresh the watchdog on every SysTick, false to only
+ * refresh it through feed_watchdog().
+ */
+void set_watchdog_keepalive(const bool enabled);
+
+/**
+ * @brief Checks if the last reset was caused by the watchdog.
+ * @return true if the watchdog reset the MCU, false otherwise.
+ * @note Clears the reset flags, so only the first call reports the reset.
+ */
+bool watchdog_caused_reset(void);
+
+/**
+ * @brief Handler for the SysTick interrupt refreshing the watchdog.
+ */
+void watchdog_tick_handler(void);
+
+#endif  // HAL_WATCHDOG_H
@@ -0,0 +1,85 @@
+#include "hal/control_timer.h"
+
+#include <stddef.h>
+
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_tim.h"
+
+#define CONTROL_TIMER TIM10
+#define CONTROL_TIMER_IRQ TIM1_UP_TIM10_IRQn
+#define CONTROL_TIMER_PRIORITY 1     // Below USART1, above SysTick
+#define COUNTER_FREQUENCY 1000000UL  // 1 us per count
+
+static ControlTimerCallback control_callback = NULL;
+
+void init_control_timer(const uint16_t period_us, const uint16_t sample_us,
+                        const ControlTimerCallback callback) {
+    control_callback = callback;
+
+    LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_TIM10);
+
+    // APB2 is not divided, so TIM10 runs from the core clock
+    LL_TIM_InitTypeDef tim_init = {0};
+    LL_TIM_StructInit(&tim_init);
+    tim_init.Prescaler = __LL_TIM_CALC_PSC(SystemCoreClock, COUNTER_FREQUENCY);
+    tim_init.Autoreload = period_us - 1;
+    LL_TIM_Init(CONTROL_TIMER, &tim_init);
+
+    LL_TIM_DisableARRPreload(CONTROL_TIMER);
+
+    // The compare is only loaded on updates, so a frame is never sampled twice
+    LL_TIM_OC_EnablePreload(CONTROL_TIMER, LL_TIM_CHANNEL_CH1);
+    LL_TIM_OC_SetCompareCH1(CONTROL_TIMER, sample_us);
+
+    NVIC_SetPriority(CONTROL_TIMER_IRQ,
+                     NVIC_EncodePriority(NVIC_GetPriorityGrouping(),
+                                         CONTROL_TIMER_PRIORITY, 0));
+    NVIC_EnableIRQ(CONTROL_TIMER_IRQ);
+}
+
+void set_control_timer_sample(const uint16_t sample_us) {
+    LL_TIM_OC_SetCompareCH1(CONTROL_TIMER, sample_us);
+}
+
+void start_control_timer(void) {
+    LL_TIM_SetCounter(CONTROL_TIMER, 0);
+    LL_TIM_ClearFlag_UPDATE(CONTROL_TIMER);
+    LL_TIM_ClearFlag_CC1(CONTROL_TIMER);
+
+    LL_TIM_EnableIT_UPDATE(CONTROL_TIMER);
+    LL_TIM_EnableIT_CC1(CONTROL_TIMER);
+
+    // Start the first frame right away instead of after a full period
+    LL_TIM_GenerateEvent_UPDATE(CONTROL_TIMER);
+    LL_TIM_EnableCounter(CONTROL_TIMER);
+}
+
+void stop_control_timer(void) {
+    LL_TIM_DisableCounter(CONTROL_TIMER);
+    LL_TIM_DisableIT_UPDATE(CONTROL_TIMER);
+    LL_TIM_DisableIT_CC1(CONTROL_TIMER);
+
+    LL_TIM_ClearFlag_UPDATE(CONTROL_TIMER);
+    LL_TIM_ClearFlag_CC1(CONTROL_TIMER);
+    NVIC_ClearPendingIRQ(CONTROL_TIMER_IRQ);
+}
+
+void mask_control_timer(void) {
+    NVIC_DisableIRQ(CONTROL_TIMER_IRQ);
+    __DSB();
+    __ISB();
+}
+
+void unmask_control_timer(void) { NVIC_EnableIRQ(CONTROL_TIMER_IRQ); }
+
+void control_timer_irq_handler(void) {
+    if (LL_TIM_IsActiveFlag_UPDATE(CONTROL_TIMER)) {
+        LL_TIM_ClearFlag_UPDATE(CONTROL_TIMER);
+        if (control_callback) control_callback();
+    }
+
+    if (LL_TIM_IsActiveFlag_CC1(CONTROL_TIMER)) {
+        LL_TIM_ClearFlag_CC1(CONTROL_TIMER);
+        if (control_callback) control_callback();
+    }
+}
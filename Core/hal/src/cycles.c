@@ -0,0 +1,13 @@
+#include "hal/cycles.h"
+
+#include "stm32f4xx.h"
+
+void init_cycle_counter(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t get_cycle_count(void) { return DWT->CYCCNT; }
+
+uint32_t get_cycle_frequency(void) { return SystemCoreClock; }
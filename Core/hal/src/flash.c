@@ -0,0 +1,97 @@
+#include "hal/flash.h"
+
+#include "stm32f4xx.h"
+
+// Sectors 6 and 7 are the last two of the 512 KB flash, so the image must
+// stay within the first 256 KB
+#define FLASH_STORE_ADDRESS 0x08040000UL
+#define FLASH_STORE_FIRST_SECTOR 6U
+
+#define FLASH_UNLOCK_KEY1 0x45670123UL
+#define FLASH_UNLOCK_KEY2 0xCDEF89ABUL
+#define FLASH_ERRORS                                                    \
+    (FLASH_SR_OPERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | \
+     FLASH_SR_PGSERR)
+
+// Linker script symbols, the .data initializers are the last part of the image
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+
+static inline uint32_t get_store_address(const uint8_t sector) {
+    return FLASH_STORE_ADDRESS + (uint32_t)sector * FLASH_STORE_SIZE;
+}
+
+static inline void wait_flash(void) {
+    while (FLASH->SR & FLASH_SR_BSY);
+}
+
+static bool unlock_flash(void) {
+    wait_flash();
+    if (FLASH->CR & FLASH_CR_LOCK) {
+        FLASH->KEYR = FLASH_UNLOCK_KEY1;
+        FLASH->KEYR = FLASH_UNLOCK_KEY2;
+    }
+
+    // Errors left by an earlier operation block the next one
+    FLASH->SR = FLASH_SR_EOP | FLASH_ERRORS;
+    return !(FLASH->CR & FLASH_CR_LOCK);
+}
+
+static void lock_flash(void) {
+    FLASH->CR = FLASH_CR_LOCK;
+
+    // The data cache may still hold the words from before the change
+    if (FLASH->ACR & FLASH_ACR_DCEN) {
+        FLASH->ACR &= ~FLASH_ACR_DCEN;
+        FLASH->ACR |= FLASH_ACR_DCRST;
+        FLASH->ACR &= ~FLASH_ACR_DCRST;
+        FLASH->ACR |= FLASH_ACR_DCEN;
+    }
+}
+
+bool check_flash_store(void) {
+    const uint32_t image_end = (uint32_t)&_sidata +
+                               ((uint32_t)&_edata - (uint32_t)&_sdata);
+    return image_end <= FLASH_STORE_ADDRESS;
+}
+
+const uint32_t* get_flash_store(const uint8_t sector) {
+    return (const uint32_t*)get_store_address(sector);
+}
+
+bool erase_flash_store(const uint8_t sector) {
+    if (sector >= FLASH_STORE_SECTORS || !unlock_flash()) return false;
+
+    // Word parallelism needs a 2.7 V to 3.6 V supply
+    FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_SER |
+                ((FLASH_STORE_FIRST_SECTOR + sector) << FLASH_CR_SNB_Pos);
+    FLASH->CR |= FLASH_CR_STRT;
+    wait_flash();
+
+    const bool erased = !(FLASH->SR & FLASH_ERRORS);
+    lock_flash();
+    return erased;
+}
+
+bool program_flash_store(const uint8_t sector, const uint32_t offset,
+                         const uint32_t* const words, const uint16_t count) {
+    if (sector >= FLASH_STORE_SECTORS || offset + count > FLASH_STORE_WORDS) {
+        return false;
+    }
+    if (!unlock_flash()) return false;
+
+    FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+
+    volatile uint32_t* const store =
+        (volatile uint32_t*)get_store_address(sector) + offset;
+    bool programmed = true;
+    for (uint16_t i = 0; i < count && programmed; i++) {
+        store[i] = words[i];
+        wait_flash();
+        programmed = !(FLASH->SR & FLASH_ERRORS);
+    }
+
+    lock_flash();
+    return programmed;
+}
@@ -3,85 +3,194 @@
 #include <string.h>
 
 #include "main.h"
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_exti.h"
+#include "stm32f4xx_ll_system.h"
+#include "stm32f4xx_ll_tim.h"
 #include "timer/time.h"
 
-typedef struct {
-    GPIO_TypeDef* port;
-    uint32_t pin;
-} SensorPin;
-
-static const SensorPin central_sensors[] = {
-    {SENSOR_IR_0_GPIO_Port, SENSOR_IR_0_Pin},
-    {SENSOR_IR_1_GPIO_Port, SENSOR_IR_1_Pin},
-    {SENSOR_IR_2_GPIO_Port, SENSOR_IR_2_Pin},
-    {SENSOR_IR_3_GPIO_Port, SENSOR_IR_3_Pin},
-    {SENSOR_IR_4_GPIO_Port, SENSOR_IR_4_Pin},
-    {SENSOR_IR_5_GPIO_Port, SENSOR_IR_5_Pin},
-    {SENSOR_IR_6_GPIO_Port, SENSOR_IR_6_Pin},
-    {SENSOR_IR_7_GPIO_Port, SENSOR_IR_7_Pin},
+#define CAPTURE_PRIORITY 0  // Above the control timer that starts the reads
+#define ALL_SENSORS_CAPTURED ((uint8_t)((1U << TOTAL_CENTRAL_SENSORS) - 1))
+
+#define SIDE_TIMER TIM11
+#define SIDE_TIMER_IRQ TIM1_TRG_COM_TIM11_IRQn
+#define SIDE_TIMER_PRIORITY 1             // Same as the control timer
+#define SIDE_SAMPLE_PERIOD_US 50          // 1 mm of travel at 20 m/s
+#define SIDE_COUNTER_FREQUENCY 1000000UL  // 1 us per count
+#define SIDE_EDGE_MASK (SIDE_EDGE_BUFFER_SIZE - 1)
+
+// The central sensors share one port and the side sensors another
+#define CENTRAL_SENSORS_PORT SENSOR_IR_0_GPIO_Port
+#define SIDE_SENSORS_PORT SENSOR_IR_LEFT_GPIO_Port
+
+#define FOR_CENTRAL_PINS(F)                                         \
+    (F(SENSOR_IR_0_Pin) | F(SENSOR_IR_1_Pin) | F(SENSOR_IR_2_Pin) | \
+     F(SENSOR_IR_3_Pin) | F(SENSOR_IR_4_Pin) | F(SENSOR_IR_5_Pin) | \
+     F(SENSOR_IR_6_Pin) | F(SENSOR_IR_7_Pin))
+
+// LL pin n is bit n, so squaring it gives bit 2n, its MODER field
+#define PIN_MASK(pin) (pin)
+#define PIN_MODER_MASK(pin) ((pin) * (pin) * GPIO_MODER_MODER0)
+#define PIN_MODER_OUTPUT(pin) ((pin) * (pin) * LL_GPIO_MODE_OUTPUT)
+
+#define CENTRAL_PINS FOR_CENTRAL_PINS(PIN_MASK)
+#define CENTRAL_MODER_MASK FOR_CENTRAL_PINS(PIN_MODER_MASK)
+#define CENTRAL_MODER_OUTPUT FOR_CENTRAL_PINS(PIN_MODER_OUTPUT)
+
+// EXTI line n serves pin n, so the line masks match the pin masks
+#define CAPTURE_LINES CENTRAL_PINS
+
+// Gathers the central sensor bits of a port value into a sensor byte
+#define PIN_BIT(value, pin, bit) (((value) & (pin)) ? (1U << (bit)) : 0U)
+#define GATHER_PINS(value)                          \
+    ((uint8_t)(PIN_BIT(value, SENSOR_IR_0_Pin, 0) | \
+               PIN_BIT(value, SENSOR_IR_1_Pin, 1) | \
+               PIN_BIT(value, SENSOR_IR_2_Pin, 2) | \
+               PIN_BIT(value, SENSOR_IR_3_Pin, 3) | \
+               PIN_BIT(value, SENSOR_IR_4_Pin, 4) | \
+               PIN_BIT(value, SENSOR_IR_5_Pin, 5) | \
+               PIN_BIT(value, SENSOR_IR_6_Pin, 6) | \
+               PIN_BIT(value, SENSOR_IR_7_Pin, 7)))
+#define GATHER_LOW(value) GATHER_PINS(value)
+#define GATHER_HIGH(value) GATHER_PINS((value) << 8)
+
+#define LUT_4(F, n) F(n), F(n + 1), F(n + 2), F(n + 3)
+#define LUT_16(F, n) \
+    LUT_4(F, n), LUT_4(F, n + 4), LUT_4(F, n + 8), LUT_4(F, n + 12)
+#define LUT_64(F, n) \
+    LUT_16(F, n), LUT_16(F, n + 16), LUT_16(F, n + 32), LUT_16(F, n + 48)
+#define LUT_256(F) \
+    LUT_64(F, 0), LUT_64(F, 64), LUT_64(F, 128), LUT_64(F, 192)
+
+// Port bits 0-7 and 8-15 to sensor bits, built by the preprocessor
+static const uint8_t gather_low_pins[256] = {LUT_256(GATHER_LOW)};
+static const uint8_t gather_high_pins[256] = {LUT_256(GATHER_HIGH)};
+
+// SYSCFG sources routing the central sensor pins (all on GPIOB) to EXTI
+static const uint32_t capture_sources[] = {
+    LL_SYSCFG_EXTI_LINE0, LL_SYSCFG_EXTI_LINE1, LL_SYSCFG_EXTI_LINE10,
+    LL_SYSCFG_EXTI_LINE3, LL_SYSCFG_EXTI_LINE4, LL_SYSCFG_EXTI_LINE5,
+    LL_SYSCFG_EXTI_LINE8, LL_SYSCFG_EXTI_LINE9,
 };
 
-static const SensorPin side_sensors[] = {
-    {SENSOR_IR_LEFT_GPIO_Port, SENSOR_IR_LEFT_Pin},
-    {SENSOR_IR_RIGHT_GPIO_Port, SENSOR_IR_RIGHT_Pin},
+static const IRQn_Type capture_irqs[] = {
+    EXTI0_IRQn,   EXTI1_IRQn,     EXTI3_IRQn, EXTI4_IRQn,
+    EXTI9_5_IRQn, EXTI15_10_IRQn,
 };
 
-static uint32_t start_time = 0;
-static uint16_t central_sensor_values[TOTAL_CENTRAL_SENSORS] = {0};
-static uint8_t central_sensor_byte = 0;
+#define TOTAL_CAPTURE_IRQS (sizeof(capture_irqs) / sizeof(capture_irqs[0]))
+
+static volatile uint32_t start_time = 0;
+static volatile uint16_t central_sensor_values[TOTAL_CENTRAL_SENSORS] = {0};
+static volatile uint8_t central_sensor_byte = 0;
 static bool central_sensor_reading_started = false;
 
+static volatile SideSensorEdge side_edges[SIDE_EDGE_BUFFER_SIZE];
+static volatile uint8_t side_edges_head = 0;  // Written by the interrupt
+static volatile uint8_t side_edges_tail = 0;  // Written by the reader
+static volatile uint8_t side_state = 0;       // Bit i set over a marker
+
+static inline uint8_t gather_sensor_pins(const uint32_t pins) {
+    return gather_low_pins[pins & 0xFF] | gather_high_pins[(pins >> 8) & 0xFF];
+}
+
 static inline void set_sensors_output_high(void) {
-    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
-        LL_GPIO_SetPinMode(central_sensors[i].port, central_sensors[i].pin,
-                           LL_GPIO_MODE_OUTPUT);
-        LL_GPIO_SetOutputPin(central_sensors[i].port, central_sensors[i].pin);
-    }
+    // Latch the pins high first, so switching them never drives them low
+    LL_GPIO_SetOutputPin(CENTRAL_SENSORS_PORT, CENTRAL_PINS);
+    MODIFY_REG(CENTRAL_SENSORS_PORT->MODER, CENTRAL_MODER_MASK,
+               CENTRAL_MODER_OUTPUT);
 }
 
 static inline void set_sensors_input(void) {
+    CLEAR_BIT(CENTRAL_SENSORS_PORT->MODER, CENTRAL_MODER_MASK);
+}
+
+static inline void close_capture_window(void) {
+    LL_EXTI_DisableIT_0_31(CAPTURE_LINES);
+}
+
+static inline uint8_t sample_side_sensors(void) {
+    const uint32_t pins = LL_GPIO_ReadInputPort(SIDE_SENSORS_PORT);
+
+    // The side sensors read low over a marker
+    return (!(pins & SENSOR_IR_LEFT_Pin) << LEFT_SIDE_SENSOR) |
+           (!(pins & SENSOR_IR_RIGHT_Pin) << RIGHT_SIDE_SENSOR);
+}
+
+static inline void push_side_edge(const uint8_t sensor, const bool active,
+                                  const uint32_t time) {
+    const uint8_t head = side_edges_head;
+    const uint8_t next = (head + 1) & SIDE_EDGE_MASK;
+    if (next == side_edges_tail) return;
+
+    side_edges[head].sensor = sensor;
+    side_edges[head].active = active;
+    side_edges[head].time_us = time;
+    side_edges_head = next;
+}
+
+static void fill_missing_values(const uint16_t timeout) {
     for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
-        LL_GPIO_SetPinMode(central_sensors[i].port, central_sensors[i].pin,
-                           LL_GPIO_MODE_INPUT);
+        if (!(central_sensor_byte & (1 << i))) {
+            central_sensor_values[i] = timeout;
+        }
     }
 }
 
-static void sensors_read_raw(const uint16_t timeout) {
-    uint8_t sensors_read = 0;
-    uint32_t read_interval = time_us() - start_time;
+void init_ir_capture(void) {
+    LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_SYSCFG);
 
-    while (read_interval < timeout && sensors_read < TOTAL_CENTRAL_SENSORS) {
-        for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
-            if (central_sensor_values[i] == 0 &&
-                !LL_GPIO_IsInputPinSet(central_sensors[i].port,
-                                       central_sensors[i].pin)) {
-                central_sensor_values[i] = read_interval;
-                sensors_read++;
-            }
-        }
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        LL_SYSCFG_SetEXTISource(LL_SYSCFG_EXTI_PORTB, capture_sources[i]);
+    }
+
+    // Lines stay masked until start_read() opens a capture window
+    close_capture_window();
+    LL_EXTI_DisableEvent_0_31(CAPTURE_LINES);
+    LL_EXTI_DisableRisingTrig_0_31(CAPTURE_LINES);
+    LL_EXTI_EnableFallingTrig_0_31(CAPTURE_LINES);
+    LL_EXTI_ClearFlag_0_31(CAPTURE_LINES);
 
-        read_interval = time_us() - start_time;
+    for (uint8_t i = 0; i < TOTAL_CAPTURE_IRQS; i++) {
+        NVIC_SetPriority(capture_irqs[i],
+                         NVIC_EncodePriority(NVIC_GetPriorityGrouping(),
+                                             CAPTURE_PRIORITY, 0));
+        NVIC_EnableIRQ(capture_irqs[i]);
     }
+}
+
+void ir_capture_irq_handler(void) {
+    const uint32_t read_interval = time_us() - start_time;
+    const uint32_t pending = LL_EXTI_ReadFlag_0_31(CAPTURE_LINES);
+    LL_EXTI_ClearFlag_0_31(pending);
 
+    // Each line only needs its first falling edge in a read
+    LL_EXTI_DisableIT_0_31(pending);
+
+    const uint8_t captured = gather_sensor_pins(pending) & ~central_sensor_byte;
     for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
-        if (central_sensor_values[i] == 0) {
-            central_sensor_values[i] = timeout;
-        } else {
-            central_sensor_byte |= (1 << i);
-        }
+        if (captured & (1 << i)) central_sensor_values[i] = read_interval;
     }
+
+    central_sensor_byte |= captured;
 }
 
 void start_read(void) {
     LL_GPIO_SetOutputPin(SENSOR_IR_INPUT_GPIO_Port, SENSOR_IR_INPUT_Pin);
-    set_sensors_input();
-    memset(central_sensor_values, 0, sizeof(central_sensor_values));
+    memset((void*)central_sensor_values, 0, sizeof(central_sensor_values));
     central_sensor_byte = 0;
+
+    LL_EXTI_ClearFlag_0_31(CAPTURE_LINES);
+    LL_EXTI_EnableIT_0_31(CAPTURE_LINES);
+
+    // The capacitors start discharging once the pins stop driving them
     start_time = time_us();
+    set_sensors_input();
     central_sensor_reading_started = true;
 }
 
 void stop_read(void) {
+    close_capture_window();
     LL_GPIO_ResetOutputPin(SENSOR_IR_INPUT_GPIO_Port, SENSOR_IR_INPUT_Pin);
     set_sensors_output_high();
     central_sensor_reading_started = false;
@@ -89,28 +198,35 @@ void stop_read(void) {
 
 uint8_t read_central_sensors(const uint16_t timeout) {
     start_read();
-    sensors_read_raw(timeout);
+
+    // The discharge times are stamped by the EXTI handler while this waits
+    while (central_sensor_is_reading(timeout)) {
+    }
+
+    close_capture_window();
+    fill_missing_values(timeout);
     stop_read();
 
     return central_sensor_byte;
 }
 
 const uint16_t* get_central_sensor_values(void) {
-    return central_sensor_values;
+    // Only written inside a capture window, which is closed once read
+    return (const uint16_t*)central_sensor_values;
 }
 
 bool central_sensor_is_reading(const uint16_t timeout) {
     return (central_sensor_reading_started &&
+            central_sensor_byte != ALL_SENSORS_CAPTURED &&
             !time_elapsed_us(start_time, timeout));
 }
 
 uint8_t read_central_sensors_async(void) {
-    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
-        if (!LL_GPIO_IsInputPinSet(central_sensors[i].port,
-                                   central_sensors[i].pin)) {
-            central_sensor_byte |= (1 << i);
-        }
-    }
+    close_capture_window();
+
+    const uint32_t read_interval = time_us() - start_time;
+    fill_missing_values(read_interval < UINT16_MAX ? read_interval
+                                                   : UINT16_MAX);
 
     return central_sensor_byte;
 }
@@ -118,10 +234,63 @@ uint8_t read_central_sensors_async(void) {
 const bool* get_side_sensor_values(void) {
     static bool side_sensor_values[TOTAL_SIDE_SENSORS] = {0};
 
+    const uint8_t state = sample_side_sensors();
+
     for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
-        side_sensor_values[i] =
-            !LL_GPIO_IsInputPinSet(side_sensors[i].port, side_sensors[i].pin);
+        side_sensor_values[i] = state & (1 << i);
     }
 
     return side_sensor_values;
 }
+
+void init_side_capture(void) {
+    LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_TIM11);
+
+    // APB2 is not divided, so TIM11 runs from the core clock
+    LL_TIM_InitTypeDef tim_init = {0};
+    LL_TIM_StructInit(&tim_init);
+    tim_init.Prescaler =
+        __LL_TIM_CALC_PSC(SystemCoreClock, SIDE_COUNTER_FREQUENCY);
+    tim_init.Autoreload = SIDE_SAMPLE_PERIOD_US - 1;
+    LL_TIM_Init(SIDE_TIMER, &tim_init);
+
+    side_state = sample_side_sensors();
+    LL_TIM_ClearFlag_UPDATE(SIDE_TIMER);
+    LL_TIM_EnableIT_UPDATE(SIDE_TIMER);
+
+    NVIC_SetPriority(SIDE_TIMER_IRQ,
+                     NVIC_EncodePriority(NVIC_GetPriorityGrouping(),
+                                         SIDE_TIMER_PRIORITY, 0));
+    NVIC_EnableIRQ(SIDE_TIMER_IRQ);
+    LL_TIM_EnableCounter(SIDE_TIMER);
+}
+
+void side_capture_irq_handler(void) {
+    if (!LL_TIM_IsActiveFlag_UPDATE(SIDE_TIMER)) return;
+    LL_TIM_ClearFlag_UPDATE(SIDE_TIMER);
+
+    const uint8_t state = sample_side_sensors();
+    const uint8_t changed = state ^ side_state;
+    if (!changed) return;
+
+    const uint32_t now = time_us();
+    side_state = state;
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        if (changed & (1 << i)) push_side_edge(i, state & (1 << i), now);
+    }
+}
+
+void clear_side_edges(void) { side_edges_tail = side_edges_head; }
+
+bool read_side_edge(SideSensorEdge* const edge) {
+    const uint8_t tail = side_edges_tail;
+    if (tail == side_edges_head) return false;
+
+    edge->sensor = side_edges[tail].sensor;
+    edge->active = side_edges[tail].active;
+    edge->time_us = side_edges[tail].time_us;
+    side_edges_tail = (tail + 1) & SIDE_EDGE_MASK;
+
+    return true;
+}
@@ -1,6 +1,10 @@
 #include "hal/spi.h"
 
+#include <stddef.h>
+
 #include "main.h"
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_dma.h"
 #include "timer/time.h"
 
 /**
@@ -15,8 +19,9 @@
  *
  * total_time = byte_time * (sent_bytes + received_bytes) = 5us
  *
- * Because of low wait time, no async methods or interrupts are used.
- * The SPI is fast enough to handle the communication in a blocking way.
+ * Setup and calibration reads are short enough to run blocking. The control
+ * loop instead starts a DMA burst along with the IR read, so the transfer
+ * overlaps the IR discharge and nothing waits on the bus.
  */
 
 #define MPU_REG_PWR_MGMT_1 0x6B
@@ -26,6 +31,8 @@
 #define MPU_ACCEL_CONFIG2 0x1D
 #define MPU_GYRO_CONFIG 0x1B
 #define MPU_REG_SMPLRT_DIV 0x19
+#define MPU_REG_FIFO_EN 0x23
+#define MPU_REG_USER_CTRL 0x6A
 
 #define START_COMMAND 0x80
 #define CLOCK_SRC 0x01
@@ -33,10 +40,29 @@
 #define DLPF_ACCEL_CONFIG 0x01  // ~184Hz
 #define ACCEL_CONFIG 0x00       // +/- 2g
 #define GYRO_CONFIG 0x18        // +/- 2000 deg/s
+#define FIFO_MODE 0x40          // Stop writing when the FIFO is full
+#define FIFO_SENSORS 0xF8       // Temperature, gyro XYZ and accel XYZ
+#define FIFO_ENABLE 0x40
+#define FIFO_RESET 0x04
 
 #define MPU_WHO_AM_I_9250_A 0x71
 #define MPU_WHO_AM_I_9250_B 0x73
 
+#define SPI_DMA DMA1
+#define SPI_DMA_CHANNEL LL_DMA_CHANNEL_0
+#define SPI_RX_STREAM LL_DMA_STREAM_3
+#define SPI_TX_STREAM LL_DMA_STREAM_4
+#define SPI_DMA_IRQ DMA1_Stream3_IRQn
+#define SPI_DMA_PRIORITY 1  // Same as the control timer that starts the reads
+#define SPI_READ_BUFFERS 2  // Half parsed by the callback, half being filled
+#define SPI_TRANSFER_SIZE (SPI_MAX_READ + 1)  // Register address first
+
+static SpiReadCallback read_callback = NULL;
+static uint8_t tx_buffer[SPI_TRANSFER_SIZE] = {0};
+static uint8_t rx_buffers[SPI_READ_BUFFERS][SPI_TRANSFER_SIZE] = {{0}};
+static uint8_t back_buffer = 0;
+static volatile bool dma_busy = false;
+
 static inline void mpu_cs_low(void) {
     // LL_GPIO_ResetOutputPin(MPU_NCS_GPIO_Port, MPU_NCS_Pin);
     LL_SPI_Enable(SPI2);
@@ -95,7 +121,10 @@ bool init_spi(void) {
 
     mpu_write_register(MPU_REG_SMPLRT_DIV, 0x00);
     mpu_write_register(MPU_ACCEL_CONFIG2, DLPF_ACCEL_CONFIG);
-    mpu_write_register(MPU_REG_CONFIG, DLPF_CONFIG);
+    mpu_write_register(MPU_REG_CONFIG, FIFO_MODE | DLPF_CONFIG);
+
+    mpu_write_register(MPU_REG_FIFO_EN, FIFO_SENSORS);
+    mpu_write_register(MPU_REG_USER_CTRL, FIFO_ENABLE | FIFO_RESET);
 
     for (uint8_t i = 0; i < 5; i++) {
         if (!check_who_am_i()) return false;
@@ -105,7 +134,37 @@ bool init_spi(void) {
     return check_who_am_i();
 }
 
+static void init_dma_stream(const uint32_t stream, const uint32_t direction,
+                            const uint32_t memory_address) {
+    LL_DMA_SetChannelSelection(SPI_DMA, stream, SPI_DMA_CHANNEL);
+    LL_DMA_SetDataTransferDirection(SPI_DMA, stream, direction);
+    LL_DMA_SetStreamPriorityLevel(SPI_DMA, stream, LL_DMA_PRIORITY_HIGH);
+    LL_DMA_SetMode(SPI_DMA, stream, LL_DMA_MODE_NORMAL);
+    LL_DMA_SetPeriphIncMode(SPI_DMA, stream, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(SPI_DMA, stream, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(SPI_DMA, stream, LL_DMA_PDATAALIGN_BYTE);
+    LL_DMA_SetMemorySize(SPI_DMA, stream, LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_DisableFifoMode(SPI_DMA, stream);
+    LL_DMA_SetPeriphAddress(SPI_DMA, stream, LL_SPI_DMA_GetRegAddr(SPI2));
+    LL_DMA_SetMemoryAddress(SPI_DMA, stream, memory_address);
+}
+
+static inline void clear_dma_flags(void) {
+    LL_DMA_ClearFlag_TC3(SPI_DMA);
+    LL_DMA_ClearFlag_HT3(SPI_DMA);
+    LL_DMA_ClearFlag_TE3(SPI_DMA);
+    LL_DMA_ClearFlag_DME3(SPI_DMA);
+    LL_DMA_ClearFlag_FE3(SPI_DMA);
+    LL_DMA_ClearFlag_TC4(SPI_DMA);
+    LL_DMA_ClearFlag_HT4(SPI_DMA);
+    LL_DMA_ClearFlag_TE4(SPI_DMA);
+    LL_DMA_ClearFlag_DME4(SPI_DMA);
+    LL_DMA_ClearFlag_FE4(SPI_DMA);
+}
+
 void read_registers(const uint8_t reg, uint8_t* buffer, const uint8_t bytes) {
+    while (dma_busy);  // A DMA read owns the bus until it completes
+
     mpu_cs_low();
     spi_write(reg | 0x80);
 
@@ -115,3 +174,73 @@ void read_registers(const uint8_t reg, uint8_t* buffer, const uint8_t bytes) {
 
     mpu_cs_high();
 }
+
+void reset_fifo(void) {
+    while (dma_busy);  // A DMA read owns the bus until it completes
+
+    mpu_write_register(MPU_REG_USER_CTRL, FIFO_ENABLE | FIFO_RESET);
+}
+
+void init_spi_dma(const SpiReadCallback callback) {
+    read_callback = callback;
+
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+
+    init_dma_stream(SPI_RX_STREAM, LL_DMA_DIRECTION_PERIPH_TO_MEMORY,
+                    (uint32_t)rx_buffers[back_buffer]);
+    init_dma_stream(SPI_TX_STREAM, LL_DMA_DIRECTION_MEMORY_TO_PERIPH,
+                    (uint32_t)tx_buffer);
+    LL_DMA_EnableIT_TC(SPI_DMA, SPI_RX_STREAM);
+
+    NVIC_SetPriority(SPI_DMA_IRQ,
+                     NVIC_EncodePriority(NVIC_GetPriorityGrouping(),
+                                         SPI_DMA_PRIORITY, 0));
+    NVIC_EnableIRQ(SPI_DMA_IRQ);
+}
+
+bool start_registers_read(const uint8_t reg, const uint8_t bytes) {
+    if (dma_busy || bytes > SPI_MAX_READ) return false;
+    dma_busy = true;
+
+    // The rest of the transmit buffer stays zeroed as dummy bytes
+    tx_buffer[0] = reg | 0x80;
+
+    clear_dma_flags();
+    LL_DMA_SetMemoryAddress(SPI_DMA, SPI_RX_STREAM,
+                            (uint32_t)rx_buffers[back_buffer]);
+    LL_DMA_SetDataLength(SPI_DMA, SPI_RX_STREAM, bytes + 1);
+    LL_DMA_SetDataLength(SPI_DMA, SPI_TX_STREAM, bytes + 1);
+    LL_DMA_EnableStream(SPI_DMA, SPI_RX_STREAM);
+    LL_DMA_EnableStream(SPI_DMA, SPI_TX_STREAM);
+
+    // Receive requests first, so no byte is missed once transmission starts
+    LL_SPI_EnableDMAReq_RX(SPI2);
+    mpu_cs_low();
+    LL_SPI_EnableDMAReq_TX(SPI2);
+
+    return true;
+}
+
+void mask_spi_dma(void) {
+    NVIC_DisableIRQ(SPI_DMA_IRQ);
+    __DSB();
+    __ISB();
+}
+
+void unmask_spi_dma(void) { NVIC_EnableIRQ(SPI_DMA_IRQ); }
+
+void spi_dma_irq_handler(void) {
+    if (!LL_DMA_IsActiveFlag_TC3(SPI_DMA)) return;
+    clear_dma_flags();
+
+    LL_SPI_DisableDMAReq_TX(SPI2);
+    LL_SPI_DisableDMAReq_RX(SPI2);
+    mpu_cs_high();
+
+    // Skip the byte clocked in while the register address was sent
+    const uint8_t* const data = &rx_buffers[back_buffer][1];
+    back_buffer = (back_buffer + 1) % SPI_READ_BUFFERS;
+    dma_busy = false;
+
+    if (read_callback) read_callback(data);
+}
@@ -1,27 +1,70 @@
 #include "hal/timer.h"
 
 #include "stm32f4xx_it.h"
+#include "stm32f4xx_ll_bus.h"
 #include "stm32f4xx_ll_cortex.h"
+#include "stm32f4xx_ll_tim.h"
 #include "stm32f4xx_ll_utils.h"
 
-void init_system_timer(void) { LL_SYSTICK_EnableIT(); }
+#define TIMEBASE_TIMER TIM5
+#define TIMEBASE_TIMER_IRQ TIM5_IRQn
+#define TIMEBASE_PRIORITY 0           // Overflows must never be missed
+#define TIMEBASE_FREQUENCY 1000000UL  // 1 us per count
+
+static volatile uint32_t timebase_overflows = 0;
+
+static void init_timebase(void) {
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM5);
+
+    // APB1 is divided by 2, so its timers run at twice PCLK1 (the core clock)
+    LL_TIM_InitTypeDef tim_init = {0};
+    LL_TIM_StructInit(&tim_init);
+    tim_init.Prescaler = __LL_TIM_CALC_PSC(SystemCoreClock, TIMEBASE_FREQUENCY);
+    tim_init.Autoreload = UINT32_MAX;
+    LL_TIM_Init(TIMEBASE_TIMER, &tim_init);
+
+    LL_TIM_SetCounter(TIMEBASE_TIMER, 0);
+    LL_TIM_ClearFlag_UPDATE(TIMEBASE_TIMER);
+    LL_TIM_EnableIT_UPDATE(TIMEBASE_TIMER);
+
+    NVIC_SetPriority(TIMEBASE_TIMER_IRQ,
+                     NVIC_EncodePriority(NVIC_GetPriorityGrouping(),
+                                         TIMEBASE_PRIORITY, 0));
+    NVIC_EnableIRQ(TIMEBASE_TIMER_IRQ);
+
+    LL_TIM_EnableCounter(TIMEBASE_TIMER);
+}
+
+void init_system_timer(void) {
+    LL_SYSTICK_EnableIT();
+    init_timebase();
+}
 
 uint32_t get_system_time(void) { return LL_GetTick(); }
 
-uint32_t get_system_time_us(void) {
-    const uint32_t load = SysTick->LOAD;
+uint32_t get_system_time_us(void) { return LL_TIM_GetCounter(TIMEBASE_TIMER); }
 
-    uint32_t ms1 = LL_GetTick();
-    uint32_t val = SysTick->VAL;
-    const uint32_t ms2 = LL_GetTick();
+uint64_t get_system_time_us64(void) {
+    // The overflow count, counter and pending flag must come from one window,
+    // or an update handled between them is counted twice
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t high = timebase_overflows;
+    const uint32_t low = LL_TIM_GetCounter(TIMEBASE_TIMER);
+    const bool pending = LL_TIM_IsActiveFlag_UPDATE(TIMEBASE_TIMER);
+    __set_PRIMASK(primask);
+
+    // Counter overflowed but the update is not handled yet
+    if (pending && low < UINT32_MAX / 2) high++;
+
+    return ((uint64_t)high << 32) | low;
+}
 
-    if (ms1 != ms2) {
-        // SysTick rolled over during read
-        val = SysTick->VAL;
-        ms1 = ms2;
-    }
+void timebase_irq_handler(void) {
+    if (!LL_TIM_IsActiveFlag_UPDATE(TIMEBASE_TIMER)) return;
 
-    return ms1 * 1000UL + (load - val) * 1000UL / (load + 1UL);
+    LL_TIM_ClearFlag_UPDATE(TIMEBASE_TIMER);
+    timebase_overflows++;
 }
 
 bool time_elapsed_ms(const uint32_t start, const uint32_t duration) {
@@ -0,0 +1,45 @@
+#include "hal/watchdog.h"
+
+#include "stm32f4xx_ll_iwdg.h"
+#include "stm32f4xx_ll_rcc.h"
+#include "stm32f4xx_ll_system.h"
+
+#define WATCHDOG_MAX_RELOAD 0x0FFF  // 12-bit reload register
+
+static volatile bool keepalive = true;
+
+void init_watchdog(const uint16_t timeout_ms) {
+    // Don't reset the MCU while the core is halted by the debugger
+    LL_DBGMCU_APB1_GRP1_FreezePeriph(LL_DBGMCU_APB1_GRP1_IWDG_STOP);
+
+    keepalive = true;
+    LL_IWDG_Enable(IWDG);
+    LL_IWDG_EnableWriteAccess(IWDG);
+
+    // The ~32 kHz LSI divided by 32 counts roughly once per ms
+    LL_IWDG_SetPrescaler(IWDG, LL_IWDG_PRESCALER_32);
+    LL_IWDG_SetReloadCounter(IWDG, timeout_ms > WATCHDOG_MAX_RELOAD
+                                       ? WATCHDOG_MAX_RELOAD
+                                       : timeout_ms);
+
+    while (!LL_IWDG_IsReady(IWDG));
+    LL_IWDG_ReloadCounter(IWDG);
+}
+
+void feed_watchdog(void) { LL_IWDG_ReloadCounter(IWDG); }
+
+void set_watchdog_keepalive(const bool enabled) {
+    // Restart the window so the handover never starts with a stale count
+    LL_IWDG_ReloadCounter(IWDG);
+    keepalive = enabled;
+}
+
+bool watchdog_caused_reset(void) {
+    const bool watchdog_reset = LL_RCC_IsActiveFlag_IWDGRST();
+    LL_RCC_ClearResetFlags();
+    return watchdog_reset;
+}
+
+void watchdog_tick_handler(void) {
+    if (keepalive) LL_IWDG_ReloadCounter(IWDG);
+}
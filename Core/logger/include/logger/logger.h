@@ -35,6 +35,9 @@
 #define debug_print_encoder_distances() ((void)0)
 #define debug_print_encoder_speeds() ((void)0)
 #define debug_print_encoder_data() ((void)0)
+#define debug_print_scheduler() ((void)0)
+#define debug_print_supervisor() ((void)0)
+#define debug_print_ir_calibration() ((void)0)
 #define debug_print_diagnostics() ((void)0)
 #endif  // DEBUG_MODE
 
@@ -196,6 +196,23 @@ void debug_print_encoder_speeds(void);
  */
 void debug_print_encoder_data(void);
 
+/**
+ * @brief Prints the completed frames and deadline misses of each scheduled
+ * task, as well as the scheduler slack.
+ */
+void debug_print_scheduler(void);
+
+/**
+ * @brief Prints the supervised control ticks, deadline overruns and whether
+ * the run was stopped by the supervisor.
+ */
+void debug_print_supervisor(void);
+
+/**
+ * @brief Prints the per-sensor IR calibration and its read window.
+ */
+void debug_print_ir_calibration(void);
+
 /**
  * @brief Prints periodic diagnostics information.
  * @return true if diagnostics were printed, false otherwise.
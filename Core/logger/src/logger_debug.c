@@ -3,10 +3,12 @@
 #include "logger/logger_base.h"
 #include "math/math.h"
 #include "pid/errors/errors.h"
+#include "scheduler/scheduler.h"
 #include "sensors/encoder.h"
 #include "sensors/mpu.h"
 #include "sensors/sensors.h"
 #include "sensors/vision.h"
+#include "supervisor/supervisor.h"
 #include "timer/time.h"
 
 #define SENSOR_READ_DEBUG_TIMEOUT_US 3000
@@ -35,36 +37,36 @@ void debug_print_new_line(void) { print_new_line(); }
 void debug_print(const char* str) { print(str); }
 
 void debug_print_central_ir_sensors(void) {
-    const SensorState* const sensors = get_sensors();
+    SensorFrame frame;
+    copy_sensor_frame(&frame);
 
-    for (int8_t i = sensors->ir_sensors->total_central_sensors - 1; i >= 0;
-         i--) {
-        print_bit(i, sensors->ir_sensors->central_sensors_state);
+    for (int8_t i = frame.ir_sensors.total_central_sensors - 1; i >= 0; i--) {
+        print_bit(i, frame.ir_sensors.central_sensors_state);
         if (i > 0) print_string(" - ");
     }
     print_new_line();
 }
 
 static inline void debug_print_ir_sensor_times(
-    const SensorState* const sensors) {
-    const uint16_t* const times = get_central_ir_sensor_times();
-    for (int8_t i = sensors->ir_sensors->total_central_sensors - 1; i >= 0;
+    const SensorFrame* const frame) {
+    for (int8_t i = frame->ir_sensors.total_central_sensors - 1; i >= 0;
          i--) {
-        print_word(times[i]);
+        print_word(frame->ir_times_us[i]);
         if (i > 0) print_string(" - ");
     }
 }
 
 void debug_print_ir_sensors(void) {
-    const SensorState* const sensors = get_sensors();
+    SensorFrame frame;
+    copy_sensor_frame(&frame);
 
-    print_bool(sensors->ir_sensors->left_sensor);
+    print_bool(frame.ir_sensors.left_sensor);
     print_string(" | ");
 
-    debug_print_ir_sensor_times(sensors);
+    debug_print_ir_sensor_times(&frame);
 
     print_string(" | ");
-    print_bool(sensors->ir_sensors->right_sensor);
+    print_bool(frame.ir_sensors.right_sensor);
 
     print_new_line();
 }
@@ -73,7 +75,7 @@ void debug_print_errors(void) {
     const ErrorStruct* const errors = get_errors();
 
     print_string("Error byte: ");
-    print_binary(errors->sensors->ir_sensors->central_sensors_state);
+    print_binary(errors->sensors->frame->ir_sensors.central_sensors_state);
     print_string(" - Error: ");
     print_signed_byte(errors->error);
     print_string(" - Last error: ");
@@ -187,6 +189,73 @@ void debug_print_encoder_data(void) {
     debug_print_encoder_speeds();
 }
 
+void debug_print_scheduler(void) {
+    const Scheduler* const scheduler = get_scheduler();
+
+    for (uint8_t i = 0; i < scheduler->task_count; i++) {
+        print_string("Task ");
+        print_string(scheduler->tasks[i].name);
+        print_string(" [runs misses]:  ");
+        print_long(scheduler->states[i].runs);
+        print_string("  /  ");
+        print_long(scheduler->states[i].deadline_misses);
+        print_new_line();
+    }
+
+    print_string("Scheduler slack (%):  ");
+    print_float(get_scheduler_slack() * 100.0f, 2);
+    print_new_line();
+}
+
+void debug_print_supervisor(void) {
+    const Supervisor* const supervisor = get_supervisor();
+
+    print_string("Control ticks [ticks overruns]:  ");
+    print_long(supervisor->ticks);
+    print_string("  /  ");
+    print_long(supervisor->overruns);
+    print_new_line();
+
+    print_string("Longest overrun run / max lateness (us):  ");
+    print_byte(supervisor->longest_overrun_run);
+    print_string("  /  ");
+    print_long(supervisor->max_lateness_us);
+    print_new_line();
+
+    if (!supervisor->tripped) return;
+
+    print_string("Run stopped by the supervisor");
+    print_new_line();
+}
+
+void debug_print_ir_calibration(void) {
+    const IrCalibration* const calibration = get_ir_calibration();
+
+    if (!calibration->valid) {
+        print_string("IR sensors not calibrated");
+        print_new_line();
+        return;
+    }
+
+    print_string("IR sensor [min threshold max] (us):");
+    print_new_line();
+
+    for (uint8_t i = 0; i < IR_CENTRAL_SENSORS; i++) {
+        print_byte(i);
+        print_string(":  ");
+        print_word(calibration->min_us[i]);
+        print_string("  /  ");
+        print_word(calibration->threshold_us[i]);
+        print_string("  /  ");
+        print_word(calibration->max_us[i]);
+        print_new_line();
+    }
+
+    print_string("Read window (us):  ");
+    print_word(calibration->read_timeout_us);
+    print_new_line();
+}
+
 static inline void update_sensor_data_for_debug(void) {
     if (!time_elapsed(last_sensor_update, SENSOR_UPDATE_INTERVAL_MS)) return;
 
@@ -60,4 +60,10 @@ void set_base_pwm_kd(const uint16_t kd);
  */
 void set_base_pwm_kff(const uint8_t kff);
 
+/**
+ * @brief Set the frame interval for the Base PWM PID controller.
+ * @param interval_us The new frame interval in microseconds.
+ */
+void set_base_pwm_frame_interval(const uint32_t interval_us);
+
 #endif  // BASE_PWM_PID_H
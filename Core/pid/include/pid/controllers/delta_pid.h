@@ -64,7 +64,17 @@ void set_delta_pwm_alpha(const float alpha);
 /**
  * @brief Set the integral windup clamp for the Delta PWM PID controller.
  * @param clamp The new integral windup clamp value.
+ * @note The clamp bounds the error integral in error units times milliseconds,
+ * so it holds the same for any frame interval.
  */
 void set_delta_pwm_clamp(const uint16_t clamp);
 
+/**
+ * @brief Set the frame interval for the Delta PWM PID controller.
+ * @param interval_us The new frame interval in microseconds.
+ * @note The I and D terms are scaled by the interval in milliseconds, so the
+ * gains keep their meaning at any rate.
+ */
+void set_delta_pwm_frame_interval(const uint32_t interval_us);
+
 #endif  // DELTA_PID_H
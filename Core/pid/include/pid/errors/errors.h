@@ -46,4 +46,26 @@ bool update_errors_async(const bool read_encoder);
  */
 void clear_errors(void);
 
+/**
+ * @brief Holds the error at a fixed value while the line is not seen.
+ * @param error Error value to hold, in whole error units.
+ * @note The delta error is zeroed and the estimate confidence dropped, so the
+ * controller steers on the held value alone until the line is seen again.
+ */
+void hold_error(const int8_t error);
+
+/**
+ * @brief Returns the line features of a central sensors bitmask.
+ * @param central_sensors_state Bitmask of the central sensors over the line.
+ * @return Pointer to the features, read from a table built at compile time.
+ */
+const LineFeatures* get_line_features(const uint8_t central_sensors_state);
+
+/**
+ * @brief Sets how the line error is computed from the central sensors.
+ * @param mode ERROR_MODE_DIGITAL for the thresholded bitmask, or
+ * ERROR_MODE_ANALOG for the sub-sensor position from the discharge times.
+ */
+void set_error_mode(const ErrorModes mode);
+
 #endif  // ERRORS_H
@@ -0,0 +1,29 @@
+#ifndef LINE_ESTIMATOR_H
+#define LINE_ESTIMATOR_H
+
+#include <stdbool.h>
+
+#include "../pid_base.h"
+
+/**
+ * @brief Clear the line estimate, so the next reading starts it anew.
+ */
+void reset_line_estimator(void);
+
+/**
+ * @brief Update the line offset estimate with a new sensor frame.
+ * @param frame Sensor frame the error was computed from.
+ * @param error Measured line error in error units.
+ * @param line_seen Whether any central sensor saw the line in the frame.
+ * @return Pointer to the updated LineEstimate structure.
+ * @note The offset and its rate are tracked by a Kalman filter driven by the
+ * gyro yaw rate and the encoder speed, then predicted forward by the time
+ * elapsed since the IR read started.
+ * @note Without the line, the estimate is only predicted and its confidence
+ * drops.
+ */
+const LineEstimate* update_line_estimator(const SensorFrame* const frame,
+                                          const float error,
+                                          const bool line_seen);
+
+#endif  // LINE_ESTIMATOR_H
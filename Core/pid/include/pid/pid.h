@@ -25,6 +25,46 @@ const PidStruct* get_pid(void);
  */
 bool update_pid(void);
 
+/**
+ * @brief Runs one PID frame without checking the frame interval.
+ * @return true if the frame was completed, false while the sensor read is
+ * still in progress.
+ * @note Meant for callers that schedule the PID frames themselves.
+ */
+bool update_pid_frame(void);
+
+/**
+ * @brief Starts running the PID frames from the control timer interrupt.
+ * @note Each frame starts the IR read at the beginning of the timer period and
+ * completes once the read window has passed, so the sensor to motor latency
+ * doesn't depend on the work done in the main loop. The completion point
+ * follows the adaptive window from frame to frame, and the window is kept
+ * short enough for the frame interval.
+ * @warning No other caller may update the PID until stop_pid_timer() is called.
+ */
+void start_pid_timer(void);
+
+/**
+ * @brief Stops running the PID frames from the control timer interrupt.
+ */
+void stop_pid_timer(void);
+
+/**
+ * @brief Gets the frame offset at which the control timer completes frames.
+ * @return The offset in microseconds from the start of each frame.
+ */
+uint16_t get_pid_sample_point(void);
+
+/**
+ * @brief Gets the shortest frame interval that fits the current IR read
+ * window and the slowest frame run so far.
+ * @return The interval in microseconds, at least 350 us with the window at
+ * SENSOR_READ_TIMEOUT_US.
+ * @note Frames run from the control timer are timed, and the interval leaves
+ * a quarter more than the slowest of them after the sample point.
+ */
+uint16_t get_pid_min_frame_interval(void);
+
 /**
  * @brief Updates the speed PID controller with the current speed error
  * values.
@@ -93,6 +133,17 @@ void set_pwm_alpha(const float alpha);
  */
 void set_pwm_clamp(const uint16_t clamp);
 
+/**
+ * @brief Set the frame interval of the PWM PID controllers.
+ * @param interval_us The new frame interval in microseconds.
+ * @return true if the interval was set, false if it is shorter than
+ * get_pid_min_frame_interval().
+ * @note When the PID runs from the control timer the new interval is used
+ * from the next start_pid_timer() call, so the serial handler rejects it
+ * while running.
+ */
+bool set_pwm_frame_interval(const uint16_t interval_us);
+
 /**
  * @brief Set the base proportional gain (Kb) value for the Base PWM PID
  * controller.
@@ -1,10 +1,16 @@
 #ifndef PID_BASE_H
 #define PID_BASE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "sensors/sensors_base.h"
 
+#define ERROR_FRACTION_BITS 8  // Fraction bits of the fine line error
+#define ERROR_SCALE (1 << ERROR_FRACTION_BITS)  // Fine error units per step
+#define ERROR_UNIT_CM 0.4f  // Sensor pitch over the error weight
+#define SENSOR_BAR_OFFSET_CM 8.0f  // Sensor bar ahead of the wheel axle
+
 /**
  * @struct SpeedErrors
  * @brief Structure to hold speed error values for PID control.
@@ -24,6 +30,36 @@ typedef struct {
     float right_delta_target_speed;  // Delta target for the right motor in cm/s
 } SpeedErrors;
 
+/**
+ * @enum ErrorModes
+ * @brief Enumeration of the ways the line error is computed.
+ */
+typedef enum {
+    ERROR_MODE_DIGITAL,  // Centroid of the thresholded sensor bitmask
+    ERROR_MODE_ANALOG,   // Centroid of the sensor discharge times
+} ErrorModes;
+
+/**
+ * @struct LineFeatures
+ * @brief Structure to hold the line features of a central sensors bitmask.
+ */
+typedef struct {
+    int8_t error;          // Digital line error, 0 without active sensors.
+    uint8_t active_count;  // Number of sensors over the line.
+    bool contiguous;       // Active sensors form a single run, or none.
+    bool crossing;         // Enough active sensors to be a crossing.
+} LineFeatures;
+
+/**
+ * @struct LineEstimate
+ * @brief Structure to hold the estimated line offset, in error units.
+ */
+typedef struct {
+    float error;        // Offset predicted to the time the motors are set.
+    float delta_error;  // Offset rate in error units per ms.
+    float confidence;   // Trust in the estimate, from 0 to 1.
+} LineEstimate;
+
 /**
  * @struct ErrorStruct
  * @brief Structure to hold error values for PID control.
@@ -36,6 +72,12 @@ typedef struct {
     int8_t feedforward;               // Feedforward value.
     int8_t max_error;                 // Maximum error value.
     int8_t min_error;                 // Minimum error value.
+    int16_t fine_error;               // Error in 1/ERROR_SCALE steps.
+    int16_t fine_delta_error;         // Delta error in 1/ERROR_SCALE steps.
+    ErrorModes mode;                  // How the error is computed.
+    float filtered_error;             // Estimated error at actuation time.
+    float filtered_delta_error;       // Estimated error rate per ms.
+    float confidence;                 // Trust in the estimate, from 0 to 1.
     const SpeedErrors* speed_errors;  // Speed error values.
     const SensorState* sensors;       // Sensor state information.
 } ErrorStruct;
@@ -50,8 +92,8 @@ typedef struct {
     uint16_t kd;              // Derivative gain
     float alpha;              // Filter coefficient
     uint16_t clamp;           // Integral windup clamp
-    uint32_t frame_interval;  // PID frame interval in ms
-    uint32_t last_pid_time;   // Last time the PID was updated
+    uint32_t frame_interval;  // PID frame interval in us
+    uint64_t last_pid_time;   // Last time the PID was updated in us
 } DeltaPid;
 
 /**
@@ -63,8 +105,8 @@ typedef struct {
     uint8_t ki;               // Integral gain
     uint16_t kd;              // Derivative gain
     uint8_t kff;              // Feedforward gain
-    uint32_t frame_interval;  // PID frame interval in ms
-    uint32_t last_pid_time;   // Last time the PID was updated
+    uint32_t frame_interval;  // PID frame interval in us
+    uint64_t last_pid_time;   // Last time the PID was updated in us
 } BasePwmPid;
 
 /**
@@ -77,10 +119,24 @@ typedef struct {
     uint16_t kd;              // Derivative gain
     uint16_t kff;             // Feedforward gain
     float base_speed;         // Base speed in cm/s
-    uint32_t frame_interval;  // PID frame interval in ms
-    uint32_t last_pid_time;   // Last time the PID was updated
+    uint32_t frame_interval;  // PID frame interval in us
+    uint64_t last_pid_time;   // Last time the PID was updated in us
 } BaseSpeedPid;
 
+/**
+ * @struct LineRecovery
+ * @brief Structure to hold the line loss recovery state and statistics.
+ */
+typedef struct {
+    bool active;             // Line lost and being steered back to.
+    int8_t side;             // Side the line was lost to, 1 left, -1 right.
+    int16_t pwm_limit;       // Base PWM cap while recovering.
+    uint64_t start_time_us;  // IR read time of the first frame without line.
+    uint16_t count;          // Recoveries since the run started.
+    uint16_t last_time_ms;   // Duration of the last recovery.
+    uint16_t max_time_ms;    // Longest recovery since the run started.
+} LineRecovery;
+
 /**
  * @struct PidStruct
  * @brief Structure to hold PID control parameters and state.
@@ -95,6 +151,7 @@ typedef struct {
     const DeltaPid* delta_pid;       // Pointer to Delta PID
     const BasePwmPid* base_pwm_pid;  // Pointer to Base PWM PID
     const BaseSpeedPid* speed_pid;   // Pointer to Base Speed PID
+    const LineRecovery* recovery;    // Pointer to the line recovery state
 } PidStruct;
 
 #endif  // PID_BASE_H
@@ -0,0 +1,30 @@
+#ifndef RECOVERY_H
+#define RECOVERY_H
+
+#include <stdint.h>
+
+#include "pid_base.h"
+
+/**
+ * @brief Initializes the line recovery with the error structure to steer.
+ * @param error_struct Pointer to the ErrorStruct used by the line PID.
+ * @return Pointer to the LineRecovery structure.
+ */
+const LineRecovery* init_line_recovery(const ErrorStruct* const error_struct);
+
+/**
+ * @brief Clears the recovery state and its statistics.
+ */
+void reset_line_recovery(void);
+
+/**
+ * @brief Checks the line after a new error frame and steers back when lost.
+ * @param current_pwm Base PWM used in the frame the line was lost.
+ * @note While lost, the error is held saturated towards the side the line was
+ * last seen, and the base PWM is capped. The cap is only lowered while gyro
+ * and encoder dead-reckoning say the robot is not closing in on the line.
+ * @note Must run in the same context as the error updates.
+ */
+void update_line_recovery(const int16_t current_pwm);
+
+#endif  // RECOVERY_H
@@ -8,7 +8,7 @@
 #define KI 0
 #define KD 0
 #define KFF 0
-#define FRAME_INTERVAL 1  // ms
+#define FRAME_INTERVAL 1000  // us
 
 static BasePwmPid base_pwm_pid = {
     .kp = KP,
@@ -21,6 +21,8 @@ static BasePwmPid base_pwm_pid = {
 
 static const ErrorStruct* errors = NULL;
 
+static float frame_ms = (float)FRAME_INTERVAL / US_PER_MS;
+
 static inline int16_t get_p(void) {
     if (base_pwm_pid.kp == 0) return 0;
 
@@ -30,13 +32,13 @@ static inline int16_t get_p(void) {
 static inline int16_t get_i(void) {
     if (base_pwm_pid.ki == 0) return 0;
 
-    return base_pwm_pid.ki * errors->error_sum * base_pwm_pid.frame_interval;
+    return base_pwm_pid.ki * errors->error_sum * frame_ms;
 }
 
 static inline int16_t get_d(void) {
     if (base_pwm_pid.kd == 0) return 0;
 
-    return base_pwm_pid.kd * errors->delta_error / base_pwm_pid.frame_interval;
+    return base_pwm_pid.kd * errors->delta_error / frame_ms;
 }
 
 static inline int16_t get_ff(void) {
@@ -57,11 +59,14 @@ int16_t get_base_pwm_pid(void) {
 }
 
 bool update_pending_base_pwm_pid(void) {
-    return time_elapsed(base_pwm_pid.last_pid_time,
-                        base_pwm_pid.frame_interval);
+    return time_elapsed_us64(base_pwm_pid.last_pid_time,
+                             base_pwm_pid.frame_interval);
 }
 
-void update_base_pwm_pid(void) { base_pwm_pid.last_pid_time = time(); }
+void update_base_pwm_pid(void) {
+    base_pwm_pid.last_pid_time = advance_period_us64(
+        base_pwm_pid.last_pid_time, base_pwm_pid.frame_interval);
+}
 
 void set_base_pwm_kp(const uint8_t kp) { base_pwm_pid.kp = kp; }
 
@@ -70,3 +75,8 @@ void set_base_pwm_ki(const uint8_t ki) { base_pwm_pid.ki = ki; }
 void set_base_pwm_kd(const uint16_t kd) { base_pwm_pid.kd = kd; }
 
 void set_base_pwm_kff(const uint8_t kff) { base_pwm_pid.kff = kff; }
+
+void set_base_pwm_frame_interval(const uint32_t interval_us) {
+    base_pwm_pid.frame_interval = interval_us;
+    frame_ms = (float)interval_us / US_PER_MS;
+}
@@ -9,7 +9,7 @@
 #define KD 4000
 #define ALPHA 1.0f
 #define CLAMP 100
-#define FRAME_INTERVAL 1  // ms
+#define FRAME_INTERVAL 1000  // us
 
 static DeltaPid delta_pid = {
     .kp = KP,
@@ -23,35 +23,43 @@ static DeltaPid delta_pid = {
 
 static const ErrorStruct* errors = NULL;
 
+static float frame_ms = (float)FRAME_INTERVAL / US_PER_MS;
 static float filtered_delta_error = 0.0f;
-static int16_t clamped_error_sum = 0;
+static float clamped_error_integral = 0.0f;
 
 static inline int16_t get_p(void) {
     if (delta_pid.kp == 0) return 0;
 
-    return delta_pid.kp * errors->error;
+    // Lean on the estimate as far as it is trusted
+    const float error = (float)errors->fine_error / ERROR_SCALE;
+    return delta_pid.kp *
+           (error + errors->confidence * (errors->filtered_error - error));
 }
 
 static inline int16_t get_i(void) {
     if (delta_pid.ki == 0) return 0;
 
-    clamped_error_sum += errors->error;
-    if (clamped_error_sum > delta_pid.clamp) {
-        clamped_error_sum = delta_pid.clamp;
-    } else if (clamped_error_sum < -delta_pid.clamp) {
-        clamped_error_sum = -delta_pid.clamp;
+    // Clamped after weighting, so the limit holds for any frame interval
+    clamped_error_integral += errors->error * frame_ms;
+    if (clamped_error_integral > delta_pid.clamp) {
+        clamped_error_integral = delta_pid.clamp;
+    } else if (clamped_error_integral < -delta_pid.clamp) {
+        clamped_error_integral = -delta_pid.clamp;
     }
 
-    return delta_pid.ki * clamped_error_sum * delta_pid.frame_interval;
+    return delta_pid.ki * clamped_error_integral;
 }
 
 static inline int16_t get_d(void) {
     if (delta_pid.kd == 0) return 0;
 
-    filtered_delta_error = delta_pid.alpha * errors->delta_error +
+    const float rate = (float)errors->fine_delta_error / ERROR_SCALE / frame_ms;
+    const float delta_error =
+        rate + errors->confidence * (errors->filtered_delta_error - rate);
+    filtered_delta_error = delta_pid.alpha * delta_error +
                            (1.0f - delta_pid.alpha) * filtered_delta_error;
 
-    return delta_pid.kd * filtered_delta_error / delta_pid.frame_interval;
+    return delta_pid.kd * filtered_delta_error;
 }
 
 const DeltaPid* init_delta_pwm_pid(const ErrorStruct* const error_struct) {
@@ -64,10 +72,13 @@ const DeltaPid* get_delta_pwm_pid_ptr(void) { return &delta_pid; }
 int16_t get_delta_pwm_pid(void) { return get_p() + get_i() + get_d(); }
 
 bool update_pending_delta_pwm_pid(void) {
-    return time_elapsed(delta_pid.last_pid_time, delta_pid.frame_interval);
+    return time_elapsed_us64(delta_pid.last_pid_time, delta_pid.frame_interval);
 }
 
-void update_delta_pwm_pid(void) { delta_pid.last_pid_time = time(); }
+void update_delta_pwm_pid(void) {
+    delta_pid.last_pid_time =
+        advance_period_us64(delta_pid.last_pid_time, delta_pid.frame_interval);
+}
 
 void set_delta_pwm_kp(const uint8_t kp) { delta_pid.kp = kp; }
 
@@ -78,3 +89,8 @@ void set_delta_pwm_kd(const uint16_t kd) { delta_pid.kd = kd; }
 void set_delta_pwm_alpha(const float alpha) { delta_pid.alpha = alpha; }
 
 void set_delta_pwm_clamp(const uint16_t clamp) { delta_pid.clamp = clamp; }
+
+void set_delta_pwm_frame_interval(const uint32_t interval_us) {
+    delta_pid.frame_interval = interval_us;
+    frame_ms = (float)interval_us / US_PER_MS;
+}
@@ -10,7 +10,7 @@
 #define KI 0.1f
 #define KD 0
 #define KFF 0
-#define FRAME_INTERVAL 10  // ms
+#define FRAME_INTERVAL 10000  // us
 
 #define BASE_SPEED 20.0f  // cm/s
 #define PWM_MAX_DELTA 100
@@ -27,6 +27,8 @@ static BaseSpeedPid base_pid = {
 
 static const SpeedErrors* speed_errors = NULL;
 
+static const float frame_ms = (float)FRAME_INTERVAL / US_PER_MS;
+
 static struct {
     float left_p;
     float right_p;
@@ -50,25 +52,21 @@ static inline void update_p(void) {
 }
 
 static inline void update_i(void) {
-    pid_struct.left_i =
-        base_pid.ki * speed_errors->left_error_sum * base_pid.frame_interval;
-    pid_struct.right_i =
-        base_pid.ki * speed_errors->right_error_sum * base_pid.frame_interval;
+    pid_struct.left_i = base_pid.ki * speed_errors->left_error_sum * frame_ms;
+    pid_struct.right_i = base_pid.ki * speed_errors->right_error_sum * frame_ms;
 }
 
 static inline void update_d(void) {
-    pid_struct.left_d =
-        base_pid.kd * speed_errors->left_delta_error / base_pid.frame_interval;
+    pid_struct.left_d = base_pid.kd * speed_errors->left_delta_error / frame_ms;
     pid_struct.right_d =
-        base_pid.kd * speed_errors->right_delta_error / base_pid.frame_interval;
+        base_pid.kd * speed_errors->right_delta_error / frame_ms;
 }
 
 static inline void update_ff(void) {
-    pid_struct.left_ff = base_pid.kff * speed_errors->left_delta_target_speed /
-                         base_pid.frame_interval;
-    pid_struct.right_ff = base_pid.kff *
-                          speed_errors->right_delta_target_speed /
-                          base_pid.frame_interval;
+    pid_struct.left_ff =
+        base_pid.kff * speed_errors->left_delta_target_speed / frame_ms;
+    pid_struct.right_ff =
+        base_pid.kff * speed_errors->right_delta_target_speed / frame_ms;
 }
 
 static inline void update_pwm(void) {
@@ -116,10 +114,13 @@ void update_base_speed_pid(void) {
 }
 
 bool update_pending_base_speed_pid(void) {
-    return time_elapsed(base_pid.last_pid_time, base_pid.frame_interval);
+    return time_elapsed_us64(base_pid.last_pid_time, base_pid.frame_interval);
 }
 
-void update_base_speed_pid_time(void) { base_pid.last_pid_time = time(); }
+void update_base_speed_pid_time(void) {
+    base_pid.last_pid_time =
+        advance_period_us64(base_pid.last_pid_time, base_pid.frame_interval);
+}
 
 void set_base_speed_kp(const uint16_t kp) { base_pid.kp = kp; }
 
@@ -3,8 +3,11 @@
 #include <stdlib.h>
 
 #include "hal/ir_sensors.h"
+#include "pid/errors/line_estimator.h"
 #include "pid/errors/speed_errors.h"
+#include "profiler/profiler.h"
 #include "sensors/sensors.h"
+#include "sensors/vision.h"
 
 #define ERROR_WEIGHT 2
 #define AVG_ERROR ((ERROR_WEIGHT * (TOTAL_CENTRAL_SENSORS - 1)) / 2)
@@ -14,6 +17,46 @@
 #define MAX_ERROR_SUM 1000
 #define MIN_ERROR_SUM -MAX_ERROR_SUM
 
+#define MAX_FINE_ERROR ((MAX_ERROR) * ERROR_SCALE)
+#define MIN_FINE_ERROR (-MAX_FINE_ERROR)
+#define ANALOG_NOISE_US 8  // Discharge spread treated as sensor noise
+#define CROSSING_SENSORS 4  // Active sensors that make a crossing
+
+_Static_assert(TOTAL_CENTRAL_SENSORS == 8,
+               "The line features table covers 8 central sensors");
+
+#define MASK_BIT(mask, i) (((mask) >> (i)) & 1)
+#define MASK_COUNT(mask)                                                  \
+    (MASK_BIT(mask, 0) + MASK_BIT(mask, 1) + MASK_BIT(mask, 2) +          \
+     MASK_BIT(mask, 3) + MASK_BIT(mask, 4) + MASK_BIT(mask, 5) +          \
+     MASK_BIT(mask, 6) + MASK_BIT(mask, 7))
+#define MASK_INDEX_SUM(mask)                                              \
+    (MASK_BIT(mask, 1) + 2 * MASK_BIT(mask, 2) + 3 * MASK_BIT(mask, 3) +  \
+     4 * MASK_BIT(mask, 4) + 5 * MASK_BIT(mask, 5) +                      \
+     6 * MASK_BIT(mask, 6) + 7 * MASK_BIT(mask, 7))
+#define MASK_ERROR(mask)                                                  \
+    (MASK_COUNT(mask) ? MASK_INDEX_SUM(mask) * ERROR_WEIGHT /             \
+                            MASK_COUNT(mask) - AVG_ERROR                  \
+                      : 0)
+
+// Filling the gaps up to the highest active bit leaves a single run
+#define MASK_CONTIGUOUS(mask) (((((mask) | ((mask) - 1)) + 1) & (mask)) == 0)
+
+#define LINE_FEATURES(mask)                                     \
+    {MASK_ERROR(mask), MASK_COUNT(mask), MASK_CONTIGUOUS(mask), \
+     MASK_COUNT(mask) >= CROSSING_SENSORS}
+
+#define LUT_4(F, n) F(n), F(n + 1), F(n + 2), F(n + 3)
+#define LUT_16(F, n) \
+    LUT_4(F, n), LUT_4(F, n + 4), LUT_4(F, n + 8), LUT_4(F, n + 12)
+#define LUT_64(F, n) \
+    LUT_16(F, n), LUT_16(F, n + 16), LUT_16(F, n + 32), LUT_16(F, n + 48)
+#define LUT_256(F) \
+    LUT_64(F, 0), LUT_64(F, 64), LUT_64(F, 128), LUT_64(F, 192)
+
+// Features of every central sensors bitmask, built by the preprocessor
+static const LineFeatures line_features[256] = {LUT_256(LINE_FEATURES)};
+
 static ErrorStruct errors = {
     .error = 0,
     .last_error = 0,
@@ -22,28 +65,109 @@ static ErrorStruct errors = {
     .feedforward = 0,
     .max_error = MAX_ERROR,
     .min_error = MIN_ERROR,
+    .fine_error = 0,
+    .fine_delta_error = 0,
+    .mode = ERROR_MODE_DIGITAL,
+    .filtered_error = 0.0f,
+    .filtered_delta_error = 0.0f,
+    .confidence = 0.0f,
     .speed_errors = NULL,
     .sensors = NULL,
 };
 
 static bool is_updating_sensors = false;
+static int16_t last_fine_error = 0;
 
-static inline void update_error(void) {
-    const uint8_t central_sensors_state =
-        errors.sensors->ir_sensors->central_sensors_state;
-    if (!central_sensors_state) return;
+static inline int8_t round_fine_error(const int16_t fine_error) {
+    const int16_t half = fine_error >= 0 ? ERROR_SCALE / 2 : -ERROR_SCALE / 2;
+    return (int8_t)((fine_error + half) / ERROR_SCALE);
+}
+
+static inline void update_digital_error(const uint8_t central_sensors_state) {
+    errors.error = line_features[central_sensors_state].error;
+    errors.fine_error = errors.error * ERROR_SCALE;
+}
+
+// Darkness of each sensor in 1/ERROR_SCALE steps of its calibrated range, so
+// sensors of different gain weigh alike and saturate over the line
+static void get_calibrated_weights(const uint16_t* const times,
+                                   uint32_t* const weights) {
+    const IrCalibration* const calibration = get_ir_calibration();
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        const uint16_t threshold = calibration->threshold_us[i];
+        const uint16_t range = calibration->max_us[i] - calibration->min_us[i];
+
+        // Above the threshold is background, as in the calibrated bitmask
+        uint16_t time = times[i];
+        if (time >= threshold) {
+            weights[i] = 0;
+            continue;
+        }
+        if (time < calibration->min_us[i]) time = calibration->min_us[i];
+
+        weights[i] = (uint32_t)(threshold - time) * ERROR_SCALE / range;
+    }
+}
+
+// Without a calibration the slowest sensor sets the background, so off-line
+// sensors weigh zero
+static void get_relative_weights(const uint16_t* const times,
+                                 uint32_t* const weights) {
+    uint16_t background = 0;
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (times[i] > background) background = times[i];
+    }
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        const uint16_t contrast = background - times[i];
+        weights[i] = 0;
+        if (contrast > ANALOG_NOISE_US) weights[i] = contrast - ANALOG_NOISE_US;
+    }
+}
+
+static void update_analog_error(const SensorFrame* const frame) {
+    uint32_t weights[TOTAL_CENTRAL_SENSORS];
+    if (get_ir_calibration()->valid) {
+        get_calibrated_weights(frame->ir_times_us, weights);
+    } else {
+        get_relative_weights(frame->ir_times_us, weights);
+    }
+
+    uint32_t weight_sum = 0;
+    uint32_t position_sum = 0;
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        weight_sum += weights[i];
+        position_sum += weights[i] * i;
+    }
 
-    uint8_t count = 0;
-    int8_t new_error = 0;
+    if (weight_sum == 0) return;
 
-    for (uint8_t i = 0; i <= TOTAL_CENTRAL_SENSORS - 1; i++) {
-        if (!(central_sensors_state & (1 << i))) continue;
+    int32_t fine_error =
+        (int32_t)(position_sum * ERROR_WEIGHT * ERROR_SCALE / weight_sum) -
+        AVG_ERROR * ERROR_SCALE;
 
-        new_error += i;
-        count++;
+    if (fine_error > MAX_FINE_ERROR) {
+        fine_error = MAX_FINE_ERROR;
+    } else if (fine_error < MIN_FINE_ERROR) {
+        fine_error = MIN_FINE_ERROR;
     }
 
-    errors.error = new_error * ERROR_WEIGHT / count - AVG_ERROR;
+    errors.fine_error = (int16_t)fine_error;
+    errors.error = round_fine_error(errors.fine_error);
+}
+
+static inline void update_error(const SensorFrame* const frame) {
+    const uint8_t central_sensors_state =
+        frame->ir_sensors.central_sensors_state;
+    if (!central_sensors_state) return;
+
+    if (errors.mode == ERROR_MODE_ANALOG) {
+        update_analog_error(frame);
+    } else {
+        update_digital_error(central_sensors_state);
+    }
 }
 
 static inline void update_error_sum(void) {
@@ -58,9 +182,23 @@ static inline void update_error_sum(void) {
 
 static inline void update_delta_error(void) {
     errors.delta_error = errors.error - errors.last_error;
+    errors.fine_delta_error = errors.fine_error - last_fine_error;
+}
+
+static inline void update_last_error(void) {
+    errors.last_error = errors.error;
+    last_fine_error = errors.fine_error;
 }
 
-static inline void update_last_error(void) { errors.last_error = errors.error; }
+static void update_estimate(const SensorFrame* const frame) {
+    const LineEstimate* const estimate = update_line_estimator(
+        frame, (float)errors.fine_error / ERROR_SCALE,
+        frame->ir_sensors.central_sensors_state != 0);
+
+    errors.filtered_error = estimate->error;
+    errors.filtered_delta_error = estimate->delta_error;
+    errors.confidence = estimate->confidence;
+}
 
 static void update_feedforward(void) {
     // TODO: Implement feedforward based on sensor data
@@ -74,7 +212,9 @@ static inline bool check_sensor_update(const bool read_encoder) {
         return false;
     }
 
+    profile_start(PROFILE_SENSORS);
     if (!update_sensors_async(read_encoder)) return false;
+    profile_end(PROFILE_SENSORS);
 
     is_updating_sensors = false;
     stop_async_sensors_read();
@@ -91,21 +231,27 @@ const ErrorStruct* get_errors(void) { return &errors; }
 
 void update_errors(const uint16_t timeout, const bool read_encoder) {
     update_sensors(timeout, read_encoder);
+    const SensorFrame* const frame = errors.sensors->frame;
 
-    update_error();
+    update_error(frame);
     update_error_sum();
     update_delta_error();
     update_last_error();
+    update_estimate(frame);
     update_feedforward();
 }
 
 bool update_errors_async(const bool read_encoder) {
     if (!check_sensor_update(read_encoder)) return false;
+    const SensorFrame* const frame = errors.sensors->frame;
 
-    update_error();
+    profile_start(PROFILE_ERROR);
+    update_error(frame);
+    profile_end(PROFILE_ERROR);
     update_error_sum();
     update_delta_error();
     update_last_error();
+    update_estimate(frame);
     update_feedforward();
 
     return true;
@@ -117,5 +263,28 @@ void clear_errors(void) {
     errors.delta_error = 0;
     errors.error_sum = 0;
     errors.feedforward = 0;
+    errors.fine_error = 0;
+    errors.fine_delta_error = 0;
+    errors.filtered_error = 0.0f;
+    errors.filtered_delta_error = 0.0f;
+    errors.confidence = 0.0f;
+    last_fine_error = 0;
     is_updating_sensors = false;
+    reset_line_estimator();
 }
+
+void hold_error(const int8_t error) {
+    errors.error = error;
+    errors.last_error = error;
+    errors.delta_error = 0;
+    errors.fine_error = (int16_t)(error * ERROR_SCALE);
+    errors.fine_delta_error = 0;
+    errors.confidence = 0.0f;
+    last_fine_error = errors.fine_error;
+}
+
+const LineFeatures* get_line_features(const uint8_t central_sensors_state) {
+    return &line_features[central_sensors_state];
+}
+
+void set_error_mode(const ErrorModes mode) { errors.mode = mode; }
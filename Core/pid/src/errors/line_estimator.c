@@ -0,0 +1,135 @@
+#include "pid/errors/line_estimator.h"
+
+#include "math/math.h"
+#include "pid/pid_base.h"
+#include "timer/time.h"
+
+#define TURN_GAIN (SENSOR_BAR_OFFSET_CM / ERROR_UNIT_CM)  // Units per rad
+#define MAX_OFFSET 7.0f            // Outermost sensor in error units
+
+#define MEASUREMENT_NOISE 0.25f  // Variance of a reading in units^2
+#define OFFSET_NOISE 10.0f       // Offset noise density in units^2/s
+#define DRIFT_NOISE 0.5f         // Drift noise density per (cm/s)^2
+#define INITIAL_DRIFT_VARIANCE 400.0f  // Drift variance when starting
+#define INNOVATION_GATE 25.0f    // Squared innovation, in variances, to trust
+#define MAX_GATED_FRAMES 5       // Rejected readings before restarting
+
+#define S_PER_US 1e-6f
+#define MS_PER_S 1000.0f
+
+static LineEstimate estimate = {0};
+
+static bool initialized = false;
+static float offset = 0.0f;  // Line offset under the sensor bar in units
+static float drift = 0.0f;   // Offset rate not caused by turning, units/s
+static float p[2][2] = {{0}};
+static uint8_t gated_frames = 0;
+
+static uint64_t last_ir_time = 0;
+static uint64_t last_mpu_time = 0;
+static float last_yaw = 0.0f;
+static float yaw_rate = 0.0f;
+
+static void restart(const SensorFrame* const frame, const float error) {
+    offset = error;
+    drift = 0.0f;
+    p[0][0] = MEASUREMENT_NOISE;
+    p[0][1] = 0.0f;
+    p[1][0] = 0.0f;
+    p[1][1] = INITIAL_DRIFT_VARIANCE;
+    gated_frames = 0;
+
+    last_ir_time = frame->ir_time_us;
+    last_mpu_time = frame->mpu_time_us;
+    last_yaw = frame->mpu_data.yaw;
+    yaw_rate = 0.0f;
+    initialized = true;
+}
+
+static void update_yaw_rate(const SensorFrame* const frame) {
+    if (frame->mpu_time_us == last_mpu_time) return;
+
+    float delta_yaw = frame->mpu_data.yaw - last_yaw;
+    normalize_angle(&delta_yaw);
+
+    yaw_rate =
+        delta_yaw / ((float)(frame->mpu_time_us - last_mpu_time) * S_PER_US);
+    last_mpu_time = frame->mpu_time_us;
+    last_yaw = frame->mpu_data.yaw;
+}
+
+static void predict(const float dt, const float speed) {
+    // Turning swings the bar across the line, and steers the drift with speed
+    offset += (drift - TURN_GAIN * yaw_rate) * dt;
+    drift -= speed / ERROR_UNIT_CM * yaw_rate * dt;
+
+    // P = F P F' + Q, with F = [1 dt; 0 1]
+    p[0][0] += dt * (p[1][0] + p[0][1] + dt * p[1][1]) + OFFSET_NOISE * dt;
+    p[0][1] += dt * p[1][1];
+    p[1][0] += dt * p[1][1];
+    p[1][1] += DRIFT_NOISE * speed * speed * dt;
+}
+
+static void correct(const SensorFrame* const frame, const float error) {
+    const float innovation = error - offset;
+    const float variance = p[0][0] + MEASUREMENT_NOISE;
+
+    // Crossings and glitches jump away from the estimate, so skip them
+    if (innovation * innovation > INNOVATION_GATE * variance) {
+        if (++gated_frames >= MAX_GATED_FRAMES) restart(frame, error);
+        return;
+    }
+
+    gated_frames = 0;
+
+    const float k0 = p[0][0] / variance;
+    const float k1 = p[1][0] / variance;
+
+    offset += k0 * innovation;
+    drift += k1 * innovation;
+
+    p[1][1] -= k1 * p[0][1];
+    p[1][0] -= k1 * p[0][0];
+    p[0][1] -= k0 * p[0][1];
+    p[0][0] -= k0 * p[0][0];
+}
+
+static void update_estimate(const SensorFrame* const frame) {
+    const float rate = drift - TURN_GAIN * yaw_rate;
+    const float delay = (float)(time_us64() - frame->ir_time_us) * S_PER_US;
+
+    float error = offset + rate * delay;
+    if (error > MAX_OFFSET) {
+        error = MAX_OFFSET;
+    } else if (error < -MAX_OFFSET) {
+        error = -MAX_OFFSET;
+    }
+
+    estimate.error = error;
+    estimate.delta_error = rate / MS_PER_S;
+    estimate.confidence = MEASUREMENT_NOISE / (MEASUREMENT_NOISE + p[0][0]);
+}
+
+void reset_line_estimator(void) {
+    estimate = (LineEstimate){0};
+    initialized = false;
+}
+
+const LineEstimate* update_line_estimator(const SensorFrame* const frame,
+                                          const float error,
+                                          const bool line_seen) {
+    if (!initialized) {
+        if (!line_seen) return &estimate;
+        restart(frame, error);
+    } else if (frame->ir_time_us > last_ir_time) {
+        const float dt = (float)(frame->ir_time_us - last_ir_time) * S_PER_US;
+        last_ir_time = frame->ir_time_us;
+
+        update_yaw_rate(frame);
+        predict(dt, frame->encoders.speed);
+        if (line_seen) correct(frame, error);
+    }
+
+    update_estimate(frame);
+    return &estimate;
+}
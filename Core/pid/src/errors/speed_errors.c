@@ -6,12 +6,13 @@
 
 static SpeedErrors errors = {0};
 
-static const EncoderData* encoders = NULL;
+static const SensorState* sensors = NULL;
 
 static float last_left_target_speed = 0.0f;
 static float last_right_target_speed = 0.0f;
 
 static inline void update_error(void) {
+    const EncoderData* const encoders = &sensors->frame->encoders;
     errors.left_error = errors.left_target_speed - encoders->left_speed;
     errors.right_error = errors.right_target_speed - encoders->right_speed;
 }
@@ -39,7 +40,7 @@ static inline void update_delta_speed(void) {
 }
 
 const SpeedErrors* init_speed_errors(const ErrorStruct* const error_struct) {
-    encoders = error_struct->sensors->encoders;
+    sensors = error_struct->sensors;
     return &errors;
 }
 
@@ -2,6 +2,7 @@
 
 #include <stdlib.h>
 
+#include "hal/control_timer.h"
 #include "motors/motors.h"
 #include "pid/controllers/base_pwm_pid.h"
 #include "pid/controllers/delta_pid.h"
@@ -9,12 +10,20 @@
 #include "pid/errors/errors.h"
 #include "pid/errors/speed_errors.h"
 #include "pid/pid_base.h"
-#include "sensors/encoder.h"
+#include "pid/recovery.h"
+#include "profiler/profiler.h"
+#include "sensors/sensors.h"
+#include "sensors/vision.h"
+#include "supervisor/supervisor.h"
 #include "timer/time.h"
 
 #define BASE_PWM 300
 #define ACCELERATION_STEP 10  // PWM units per update
 
+#define PID_SAMPLE_MARGIN_US 20  // Completes each frame after the read window
+#define PID_FRAME_BUDGET_US 30   // Least time left to run the frame
+#define PID_FRAME_HEADROOM_SHIFT 2  // Budgets a quarter over the slowest frame
+
 static PidStruct pid = {
     .base_pwm = BASE_PWM,
     .current_pwm = BASE_PWM,
@@ -25,8 +34,52 @@ static PidStruct pid = {
     .delta_pid = NULL,
     .base_pwm_pid = NULL,
     .speed_pid = NULL,
+    .recovery = NULL,
 };
 
+// Frame offset at which the control timer completes the frame
+static uint16_t sample_us = SENSOR_READ_TIMEOUT_US + PID_SAMPLE_MARGIN_US;
+// Slowest frame run from the control timer since startup, from its sample
+// point to the end of the supervised tick
+static uint16_t slowest_frame_us = 0;
+
+static inline uint16_t get_sample_point(void) {
+    return get_ir_sensors()->read_window_us + PID_SAMPLE_MARGIN_US;
+}
+
+static inline uint16_t get_frame_budget(void) {
+    const uint16_t budget =
+        slowest_frame_us + (slowest_frame_us >> PID_FRAME_HEADROOM_SHIFT);
+    return budget > PID_FRAME_BUDGET_US ? budget : PID_FRAME_BUDGET_US;
+}
+
+static uint16_t get_window_limit(void) {
+    const uint32_t reserved = get_frame_budget() + PID_SAMPLE_MARGIN_US;
+    const uint32_t frame_us = pid.delta_pid->frame_interval;
+
+    return frame_us > reserved ? (uint16_t)(frame_us - reserved) : 0;
+}
+
+static void update_frame_budget(void) {
+    const Supervisor* const supervisor = get_supervisor();
+    if (!supervisor->active) return;
+
+    // Timed against the frame the supervisor just closed, so the interrupt
+    // entry counts as well
+    const uint64_t sampled_at =
+        supervisor->frame_start - supervisor->period_us + sample_us;
+    const uint64_t now = time_us64();
+    if (now <= sampled_at) return;
+
+    const uint64_t frame_us = now - sampled_at;
+    if (frame_us <= slowest_frame_us) return;
+
+    slowest_frame_us = frame_us > UINT16_MAX ? UINT16_MAX : (uint16_t)frame_us;
+
+    // A slower frame leaves less of the interval to the read window
+    set_ir_window_limit(get_window_limit());
+}
+
 static inline bool updates_pending(void) {
     return update_pending_delta_pwm_pid() || update_pending_base_pwm_pid();
 }
@@ -42,10 +95,13 @@ static inline void update_current_pwm(void) {
 
     if (accel_pwm >= ref_pwm) {
         pid.current_pwm = ref_pwm;
-        return;
+    } else {
+        pid.current_pwm = accel_pwm;
     }
 
-    pid.current_pwm = accel_pwm;
+    if (pid.recovery->active && pid.current_pwm > pid.recovery->pwm_limit) {
+        pid.current_pwm = pid.recovery->pwm_limit;
+    }
 }
 
 static int16_t get_new_pwm(const int16_t delta_term) {
@@ -60,12 +116,16 @@ static int16_t get_new_pwm(const int16_t delta_term) {
 }
 
 static void update_motors(void) {
+    profile_start(PROFILE_DELTA_PID);
     const int16_t delta_pwm = get_delta_pwm_pid();
+    profile_end(PROFILE_DELTA_PID);
 
     const int16_t left_pwm = get_new_pwm(-delta_pwm);
     const int16_t right_pwm = get_new_pwm(delta_pwm);
 
+    profile_start(PROFILE_MOTORS);
     set_motors(left_pwm, right_pwm);
+    profile_end(PROFILE_MOTORS);
 }
 
 const PidStruct* init_pid(const SensorState* const sensors) {
@@ -76,6 +136,7 @@ const PidStruct* init_pid(const SensorState* const sensors) {
     pid.delta_pid = init_delta_pwm_pid(pid.errors);
     pid.base_pwm_pid = init_base_pwm_pid(pid.errors);
     pid.speed_pid = init_base_speed_pid(pid.errors);
+    pid.recovery = init_line_recovery(pid.errors);
 
     return &pid;
 }
@@ -87,16 +148,67 @@ bool update_pid(void) {
     if (!update_errors_async(false)) return false;
 
     update_pid_times();
+    update_line_recovery(pid.current_pwm);
+    update_motors();
+
+    return true;
+}
+
+bool update_pid_frame(void) {
+    if (!update_errors_async(false)) return false;
+
+    update_delta_pwm_pid();
+    update_base_pwm_pid();
+    update_line_recovery(pid.current_pwm);
     update_motors();
 
     return true;
 }
 
+static void handle_pid_timer(void) {
+    if (!update_pid_frame()) return;
+
+    supervise_tick();
+    update_frame_budget();
+
+    // The read window adapts between frames, the next one samples after it
+    const uint16_t sample = get_sample_point();
+    if (sample != sample_us) {
+        sample_us = sample;
+        set_control_timer_sample(sample_us);
+    }
+
+    profile_end(PROFILE_PERIOD);
+    profile_start(PROFILE_PERIOD);
+}
+
+void start_pid_timer(void) {
+    // The window may not grow past the point the frame can still complete
+    reset_line_recovery();
+    set_ir_window_limit(get_window_limit());
+    sample_us = get_sample_point();
+
+    init_control_timer((uint16_t)pid.delta_pid->frame_interval, sample_us,
+                       handle_pid_timer);
+    start_control_timer();
+}
+
+void stop_pid_timer(void) {
+    stop_control_timer();
+    set_ir_window_limit(SENSOR_READ_TIMEOUT_US);
+}
+
+uint16_t get_pid_sample_point(void) { return sample_us; }
+
+uint16_t get_pid_min_frame_interval(void) {
+    return get_sample_point() + get_frame_budget();
+}
+
 bool update_speed_pid(void) {
     if (!update_pending_base_speed_pid()) return false;
 
     update_base_speed_pid_time();
-    update_encoder_data();
+    update_encoder_sensors();
     set_speed_targets(pid.speed_pid->base_speed, pid.speed_pid->base_speed);
     update_speed_errors();
     update_base_speed_pid();
@@ -163,6 +275,15 @@ void set_pwm_alpha(const float alpha) { set_delta_pwm_alpha(alpha); }
 
 void set_pwm_clamp(const uint16_t clamp) { set_delta_pwm_clamp(clamp); }
 
+bool set_pwm_frame_interval(const uint16_t interval_us) {
+    // Shorter frames would overrun until the supervisor stops the run
+    if (interval_us < get_pid_min_frame_interval()) return false;
+
+    set_delta_pwm_frame_interval(interval_us);
+    set_base_pwm_frame_interval(interval_us);
+    return true;
+}
+
 void set_pwm_kb(const uint8_t kb) { set_base_pwm_kp(kb); }
 
 void set_pwm_kff(const uint8_t kff) { set_base_pwm_kff(kff); }
@@ -0,0 +1,117 @@
+#include "pid/recovery.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#include "math/math.h"
+#include "pid/errors/errors.h"
+#include "pid/pid_base.h"
+#include "timer/time.h"
+#include "track/observer.h"
+
+#define RECOVERY_BRAKE_STEP 4      // PWM units per frame not closing in
+#define RECOVERY_MIN_PWM 100       // Lowest base PWM while recovering
+
+static LineRecovery recovery = {
+    .active = false,
+    .side = 0,
+    .pwm_limit = 0,
+    .start_time_us = 0,
+    .count = 0,
+    .last_time_ms = 0,
+    .max_time_ms = 0,
+};
+
+static const ErrorStruct* errors = NULL;
+
+static float start_yaw = 0.0f;
+static float last_distance = 0.0f;
+static float lateral = 0.0f;  // Axle displacement towards the line in cm
+static float last_gap = 0.0f;
+
+static int8_t get_lost_side(const LostType lost) {
+    if (lost == LEFT) return -1;
+    if (lost == RIGHT) return 1;
+
+    // Lost to pitch, the line is still where it was last seen
+    const float error = errors->filtered_error != 0.0f
+                            ? errors->filtered_error
+                            : (float)errors->fine_error;
+    return error >= 0.0f ? 1 : -1;
+}
+
+static void start_recovery(const LostType lost, const int16_t current_pwm) {
+    const SensorFrame* const frame = errors->sensors->frame;
+
+    recovery.active = true;
+    recovery.side = get_lost_side(lost);
+    recovery.pwm_limit = current_pwm;
+    recovery.start_time_us = frame->ir_time_us;
+
+    start_yaw = frame->mpu_data.yaw;
+    last_distance = frame->encoders.distance;
+    lateral = 0.0f;
+    last_gap = errors->max_error * ERROR_UNIT_CM;
+}
+
+static void finish_recovery(void) {
+    const uint64_t elapsed_us =
+        errors->sensors->frame->ir_time_us - recovery.start_time_us;
+    const uint64_t elapsed_ms = elapsed_us / US_PER_MS;
+    const uint16_t time_ms =
+        elapsed_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)elapsed_ms;
+
+    recovery.active = false;
+    recovery.last_time_ms = time_ms;
+    if (time_ms > recovery.max_time_ms) recovery.max_time_ms = time_ms;
+    if (recovery.count < UINT16_MAX) recovery.count++;
+}
+
+static bool closing_in(void) {
+    const SensorFrame* const frame = errors->sensors->frame;
+
+    float turned = frame->mpu_data.yaw - start_yaw;
+    normalize_angle(&turned);
+    const float sin_turned = (float)recovery.side * sinf(turned);
+
+    // Dead-reckon the sensor bar against the line, as if it ran straight
+    lateral += (frame->encoders.distance - last_distance) * sin_turned;
+    last_distance = frame->encoders.distance;
+
+    const float line = errors->max_error * ERROR_UNIT_CM;
+    const float gap = line - lateral - SENSOR_BAR_OFFSET_CM * sin_turned;
+
+    // Past the reckoned line and still blind, the line curves away
+    const bool closing = gap < last_gap && gap > 0.0f;
+    last_gap = gap;
+    return closing;
+}
+
+const LineRecovery* init_line_recovery(const ErrorStruct* const error_struct) {
+    errors = error_struct;
+    return &recovery;
+}
+
+void reset_line_recovery(void) {
+    recovery = (LineRecovery){0};
+}
+
+void update_line_recovery(const int16_t current_pwm) {
+    const LostType lost = check_line(errors->sensors->frame);
+
+    if (lost == NONE) {
+        if (recovery.active) finish_recovery();
+        return;
+    }
+
+    if (!recovery.active) start_recovery(lost, current_pwm);
+
+    hold_error((int8_t)(recovery.side * errors->max_error));
+
+    if (closing_in()) return;
+
+    recovery.pwm_limit -= RECOVERY_BRAKE_STEP;
+    if (recovery.pwm_limit < RECOVERY_MIN_PWM) {
+        recovery.pwm_limit = RECOVERY_MIN_PWM;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "config.h"
+#include "profiler/profiler_base.h"
+
+/**
+ * @brief Initializes the profiler and the cycle counter.
+ */
+void init_profiler(void);
+
+/**
+ * @brief Clears the statistics of all stages.
+ */
+void reset_profiler(void);
+
+/**
+ * @brief Returns the timing statistics of a stage.
+ * @param stage The profiled stage.
+ * @return Pointer to the statistics of the stage, or NULL if invalid.
+ */
+const ProfileStats* get_profile_stats(const ProfileStages stage);
+
+/**
+ * @brief Marks the start of a stage.
+ * @param stage The profiled stage.
+ */
+void start_profile_stage(const ProfileStages stage);
+
+/**
+ * @brief Marks the end of a stage and records its duration.
+ * @param stage The profiled stage.
+ * @note Does nothing if the stage was not started.
+ */
+void end_profile_stage(const ProfileStages stage);
+
+#ifdef PROFILING_MODE
+#define profile_start(stage) start_profile_stage(stage)
+#define profile_end(stage) end_profile_stage(stage)
+#else
+#define profile_start(stage) ((void)0)
+#define profile_end(stage) ((void)0)
+#endif  // PROFILING_MODE
+
+#endif  // PROFILER_H
@@ -0,0 +1,39 @@
+#ifndef PROFILER_BASE_H
+#define PROFILER_BASE_H
+
+#include <stdint.h>
+
+#define PROFILE_BUCKETS 15           // Number of histogram buckets per stage
+#define PROFILE_FIRST_BUCKET_NS 128  // Upper bound of the first bucket
+
+/**
+ * @enum ProfileStages
+ * @brief Enumeration of the profiled stages of a control tick.
+ */
+typedef enum {
+    PROFILE_SENSORS,    // update_sensors_async() completing a read
+    PROFILE_ERROR,      // update_error() line error computation
+    PROFILE_DELTA_PID,  // get_delta_pwm_pid() controller output
+    PROFILE_MOTORS,     // set_motors() PWM update
+    PROFILE_TRACK,      // update_track() odometry and markers
+    PROFILE_SERIAL,     // process_serial_messages() command handling
+    PROFILE_PERIOD,     // Interval between completed control ticks
+    PROFILE_STAGE_COUNT
+} ProfileStages;
+
+/**
+ * @struct ProfileStats
+ * @brief Structure to hold the timing statistics of a profiled stage.
+ * @note Bucket 0 holds durations below PROFILE_FIRST_BUCKET_NS and each
+ * following bucket doubles the bound of the previous one, with the last bucket
+ * holding every longer duration.
+ */
+typedef struct {
+    uint32_t count;                       // Number of samples
+    uint32_t min_ns;                      // Shortest duration in ns
+    uint32_t max_ns;                      // Longest duration in ns
+    uint64_t total_ns;                    // Sum of all durations in ns
+    uint32_t histogram[PROFILE_BUCKETS];  // Samples per log2 bucket
+} ProfileStats;
+
+#endif  // PROFILER_BASE_H
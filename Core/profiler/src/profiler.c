@@ -0,0 +1,72 @@
+#include "profiler/profiler.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hal/cycles.h"
+
+#define NS_PER_S 1000000000ULL
+#define SCALE_SHIFT 16  // Fixed point bits of the cycles to ns scale
+
+static ProfileStats stats[PROFILE_STAGE_COUNT];
+static uint32_t stage_starts[PROFILE_STAGE_COUNT] = {0};
+static bool stage_started[PROFILE_STAGE_COUNT] = {false};
+static uint64_t ns_per_cycle = 0;  // Scaled by 2^SCALE_SHIFT
+
+static inline uint32_t cycles_to_ns(const uint32_t cycles) {
+    const uint64_t ns = ((uint64_t)cycles * ns_per_cycle) >> SCALE_SHIFT;
+    return ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+static inline uint8_t get_bucket(const uint32_t ns) {
+    if (ns < PROFILE_FIRST_BUCKET_NS) return 0;
+
+    // Position of the highest set bit relative to the first bucket bound
+    const uint8_t bucket = (uint8_t)(__builtin_clz(PROFILE_FIRST_BUCKET_NS) -
+                                     __builtin_clz(ns) + 1);
+
+    return bucket < PROFILE_BUCKETS ? bucket : PROFILE_BUCKETS - 1;
+}
+
+static void record_sample(ProfileStats* const stage_stats, const uint32_t ns) {
+    if (!stage_stats->count || ns < stage_stats->min_ns) {
+        stage_stats->min_ns = ns;
+    }
+    if (ns > stage_stats->max_ns) stage_stats->max_ns = ns;
+
+    stage_stats->count++;
+    stage_stats->total_ns += ns;
+    stage_stats->histogram[get_bucket(ns)]++;
+}
+
+void init_profiler(void) {
+    init_cycle_counter();
+    ns_per_cycle = (NS_PER_S << SCALE_SHIFT) / get_cycle_frequency();
+    reset_profiler();
+}
+
+void reset_profiler(void) {
+    memset(stats, 0, sizeof(stats));
+    memset(stage_started, 0, sizeof(stage_started));
+}
+
+const ProfileStats* get_profile_stats(const ProfileStages stage) {
+    if (stage >= PROFILE_STAGE_COUNT) return NULL;
+    return &stats[stage];
+}
+
+void start_profile_stage(const ProfileStages stage) {
+    if (stage >= PROFILE_STAGE_COUNT) return;
+
+    stage_starts[stage] = get_cycle_count();
+    stage_started[stage] = true;
+}
+
+void end_profile_stage(const ProfileStages stage) {
+    const uint32_t end = get_cycle_count();
+    if (stage >= PROFILE_STAGE_COUNT || !stage_started[stage]) return;
+
+    stage_started[stage] = false;
+    record_sample(&stats[stage], cycles_to_ns(end - stage_starts[stage]));
+}
@@ -32,12 +32,26 @@ const PurePursuit* get_pure_pursuit(void);
  */
 bool update_peripheral_sensors(void);
 
+/**
+ * @brief Reads the peripheral sensors without checking the update interval.
+ * @return true if the sensors were updated, false while the sensor read is
+ * still in progress.
+ * @note Meant for callers that schedule the sensor reads themselves.
+ */
+bool update_peripheral_sensors_frame(void);
+
 /**
  * @brief Updates the Pure Pursuit controller.
  * @return true if the update was performed, false otherwise.
  */
 bool update_pure_pursuit(void);
 
+/**
+ * @brief Runs one Pure Pursuit frame without checking the frame interval.
+ * @note Meant for callers that schedule the frames themselves.
+ */
+void update_pure_pursuit_frame(void);
+
 /**
  * @brief Restarts the Pure Pursuit controller, resetting its internal state.
  */
@@ -6,7 +6,7 @@
 #include "motors/motors.h"
 #include "pid/controllers/speed_pid.h"
 #include "pid/errors/speed_errors.h"
-#include "sensors/encoder.h"
+#include "profiler/profiler.h"
 #include "sensors/sensors.h"
 #include "timer/time.h"
 #include "track/track.h"
@@ -40,8 +40,10 @@ static struct {
 } pp_state = {0};
 
 static inline bool out_of_range(void) {
-    const float dx = waypoints_x[pp_state.waypoint_index] - pp.track->x;
-    const float dy = waypoints_y[pp_state.waypoint_index] - pp.track->y;
+    const float dx =
+        waypoints_x[pp_state.waypoint_index] * WAYPOINT_UNIT_CM - pp.track->x;
+    const float dy =
+        waypoints_y[pp_state.waypoint_index] * WAYPOINT_UNIT_CM - pp.track->y;
     return (dx * dx + dy * dy) >= (pp.lookahead * pp.lookahead);
 }
 
@@ -52,8 +54,8 @@ static inline void update_next_waypoint(void) {
             (pp_state.waypoint_index + 1) % WAYPOINT_COUNT;
     }
 
-    pp_state.next_x = waypoints_x[pp_state.waypoint_index];
-    pp_state.next_y = waypoints_y[pp_state.waypoint_index];
+    pp_state.next_x = waypoints_x[pp_state.waypoint_index] * WAYPOINT_UNIT_CM;
+    pp_state.next_y = waypoints_y[pp_state.waypoint_index] * WAYPOINT_UNIT_CM;
 }
 
 static inline void update_targets(void) {
@@ -75,7 +77,7 @@ static inline void update_target_speeds(void) {
     const float y_r = pp.track->cos_heading * dy - pp.track->sin_heading * dx;
 
     const float curvature =
-        pp.pid->errors->sensors->encoders->effective_wheel_base * y_r *
+        pp.pid->errors->sensors->frame->encoders.effective_wheel_base * y_r *
         inv_lookahead_sq;
 
     pp_state.speed_left = pp.pid->speed_pid->base_speed * (1 - curvature);
@@ -89,7 +91,9 @@ static inline bool check_sensor_update(void) {
         return false;
     }
 
+    profile_start(PROFILE_SENSORS);
     if (!update_sensors_async(false)) return false;
+    profile_end(PROFILE_SENSORS);
 
     is_updating_sensors = false;
     stop_async_sensors_read();
@@ -107,6 +111,10 @@ const PurePursuit* get_pure_pursuit(void) { return &pp; }
 
 bool update_peripheral_sensors(void) {
     if (!time_elapsed(last_track_update, SENSORS_UPDATE_INTERVAL)) return false;
+    return update_peripheral_sensors_frame();
+}
+
+bool update_peripheral_sensors_frame(void) {
     if (!check_sensor_update()) return false;
 
     last_track_update = time();
@@ -116,16 +124,19 @@ bool update_peripheral_sensors(void) {
 bool update_pure_pursuit(void) {
     if (!update_pending_base_speed_pid()) return false;
 
+    update_pure_pursuit_frame();
+    return true;
+}
+
+void update_pure_pursuit_frame(void) {
     update_base_speed_pid_time();
-    update_encoder_data();
+    update_encoder_sensors();
     update_positions();
     update_target_speeds();
 
     set_speed_targets(pp_state.speed_left, pp_state.speed_right);
     update_speed_errors();
     update_base_speed_pid();
-
-    return true;
 }
 
 void restart_pure_pursuit(void) {
@@ -0,0 +1,43 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "scheduler/scheduler_base.h"
+
+/**
+ * @brief Starts the scheduler with a new task table.
+ * @param tasks Pointer to the static task table.
+ * @param count The number of tasks in the table.
+ * @return Pointer to the Scheduler structure, or NULL if the table is too
+ * large.
+ * @note Releases are counted from the time of this call, so it should be made
+ * right before the scheduling loop.
+ */
+const Scheduler* init_scheduler(const SchedulerTask* const tasks,
+                                const uint8_t count);
+
+/**
+ * @brief Returns a pointer to the Scheduler structure.
+ * @return Pointer to the Scheduler containing the tasks and statistics.
+ */
+const Scheduler* get_scheduler(void);
+
+/**
+ * @brief Runs the highest priority task whose release time has passed.
+ * @return true if a task was run, false if the scheduler was idle.
+ * @note Releases follow the task period from the first release, so late runs
+ * don't shift the following frames. A frame finished after the next release
+ * counts as a deadline miss, and frames that were overrun entirely are skipped
+ * and counted as misses instead of being run back to back.
+ */
+bool run_scheduler(void);
+
+/**
+ * @brief Returns the share of time the scheduler has been idle.
+ * @return The idle time as a fraction of the time since the scheduler started.
+ */
+float get_scheduler_slack(void);
+
+#endif  // SCHEDULER_H
@@ -0,0 +1,51 @@
+#ifndef SCHEDULER_BASE_H
+#define SCHEDULER_BASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS 8  // Maximum number of tasks in a task table
+
+/**
+ * @brief Function run by a scheduled task once per frame.
+ * @return true if the frame was completed, false if it is still in progress
+ * and the task must be run again before lower priority tasks.
+ */
+typedef bool (*SchedulerTaskFunction)(void);
+
+/**
+ * @struct SchedulerTask
+ * @brief Structure to hold the static definition of a scheduled task.
+ */
+typedef struct {
+    const char* name;           // Task name for diagnostics
+    SchedulerTaskFunction run;  // Function run on every release
+    uint32_t period_us;         // Interval between releases in us
+    uint32_t phase_us;          // Offset of the first release in us
+    uint8_t priority;           // Lower values run first
+} SchedulerTask;
+
+/**
+ * @struct SchedulerTaskState
+ * @brief Structure to hold the runtime state of a scheduled task.
+ */
+typedef struct {
+    uint64_t release_time;     // Release time of the pending frame in us
+    uint32_t runs;             // Completed frames
+    uint32_t deadline_misses;  // Frames finished late or skipped
+} SchedulerTaskState;
+
+/**
+ * @struct Scheduler
+ * @brief Structure to hold the scheduler task table and statistics.
+ */
+typedef struct {
+    const SchedulerTask* tasks;                      // Static task table
+    SchedulerTaskState states[SCHEDULER_MAX_TASKS];  // Per task state
+    uint8_t task_count;                              // Tasks in the table
+    uint64_t start_time;                             // Scheduler start in us
+    uint64_t last_pass_time;                         // Last pass time in us
+    uint64_t idle_time;                              // Time with no task due
+} Scheduler;
+
+#endif  // SCHEDULER_BASE_H
@@ -0,0 +1,88 @@
+#include "scheduler/scheduler.h"
+
+#include <stddef.h>
+
+#include "timer/time.h"
+
+static Scheduler scheduler = {0};
+
+static inline bool is_released(const uint64_t release_time,
+                               const uint64_t now) {
+    return now >= release_time;
+}
+
+static int8_t get_next_task(const uint64_t now) {
+    int8_t next = -1;
+
+    for (uint8_t i = 0; i < scheduler.task_count; i++) {
+        if (!is_released(scheduler.states[i].release_time, now)) continue;
+
+        if (next < 0 ||
+            scheduler.tasks[i].priority < scheduler.tasks[next].priority) {
+            next = (int8_t)i;
+        }
+    }
+
+    return next;
+}
+
+static void complete_frame(const uint8_t index, const uint64_t now) {
+    SchedulerTaskState* const state = &scheduler.states[index];
+    const uint32_t period = scheduler.tasks[index].period_us;
+
+    state->runs++;
+    state->release_time += period;
+
+    // The frame ran past its deadline, which is the next release
+    if (is_released(state->release_time, now)) state->deadline_misses++;
+
+    // Skip the frames that were overrun entirely
+    while (is_released(state->release_time + period, now)) {
+        state->release_time += period;
+        state->deadline_misses++;
+    }
+}
+
+const Scheduler* init_scheduler(const SchedulerTask* const tasks,
+                                const uint8_t count) {
+    if (count > SCHEDULER_MAX_TASKS) return NULL;
+
+    const uint64_t now = time_us64();
+
+    scheduler = (Scheduler){0};
+    scheduler.tasks = tasks;
+    scheduler.task_count = count;
+    scheduler.start_time = now;
+    scheduler.last_pass_time = now;
+
+    for (uint8_t i = 0; i < count; i++) {
+        scheduler.states[i].release_time = now + tasks[i].phase_us;
+    }
+
+    return &scheduler;
+}
+
+const Scheduler* get_scheduler(void) { return &scheduler; }
+
+bool run_scheduler(void) {
+    const uint64_t now = time_us64();
+    const int8_t next = get_next_task(now);
+
+    if (next < 0) {
+        scheduler.idle_time += now - scheduler.last_pass_time;
+        scheduler.last_pass_time = now;
+        return false;
+    }
+
+    if (scheduler.tasks[next].run()) complete_frame((uint8_t)next, time_us64());
+
+    scheduler.last_pass_time = time_us64();
+    return true;
+}
+
+float get_scheduler_slack(void) {
+    const uint64_t elapsed = scheduler.last_pass_time - scheduler.start_time;
+    if (!elapsed) return 0.0f;
+
+    return (float)scheduler.idle_time / (float)elapsed;
+}
@@ -0,0 +1,24 @@
+#ifndef MARKERS_H
+#define MARKERS_H
+
+#include <stdbool.h>
+
+#include "sensors/sensors_base.h"
+
+/**
+ * @brief Drops the pending side sensor edges and the pulses in progress.
+ */
+void clear_side_pulses(void);
+
+/**
+ * @brief Reads the oldest side sensor pulse completed since the last call.
+ * @param pulse Where to store the pulse.
+ * @param frame The sensor frame edge distances are extrapolated from.
+ * @return true if a pulse was completed, false otherwise.
+ * @note Edge times are turned into encoder distance by extrapolating the
+ * frame with its measured speed, so pulse lengths don't depend on how often
+ * the sensors are polled.
+ */
+bool read_side_pulse(SidePulse* const pulse, const SensorFrame* const frame);
+
+#endif  // MARKERS_H
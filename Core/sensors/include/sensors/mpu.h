@@ -2,6 +2,7 @@
 #define MPU_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "sensors/sensors_base.h"
 
@@ -17,12 +18,27 @@ bool init_mpu(void);
  */
 const MpuData* get_mpu_data(void);
 
+/**
+ * @brief Returns the time the current MPU data was sampled.
+ * @return Sample time in microseconds.
+ */
+uint64_t get_mpu_time_us(void);
+
 /**
  * @brief Reads data from the MPU-9250 sensor and updates the internal data
  * structure.
  */
 void update_mpu_data(void);
 
+/**
+ * @brief Starts a non-blocking burst read of the MPU-9250 sensor.
+ * @param time_us Time the read was requested, used as its sample time.
+ * @return true if the read was started, false if one is still in progress.
+ * @note The data is parsed and integrated from the SPI DMA interrupt, so the
+ * caller never waits on the bus.
+ */
+bool start_mpu_read(const uint64_t time_us);
+
 /**
  * @brief Clears the MPU data structure, setting all values to zero.
  */
@@ -34,7 +50,46 @@ void clear_mpu_data(void);
 void restart_mpu(void);
 
 /**
- * @brief Calibrates the gyroscope of the MPU-9250 sensor.
+ * @brief Tracks the yaw bias drift during runs from the encoder motion.
+ * @param encoders Encoder data just updated.
+ * @note Gyro samples taken while the encoders show the robot still or going
+ * straight are compared with their rotation, and the difference updates a
+ * bias model that follows the MPU temperature. Must run with the SPI DMA
+ * interrupt held off.
+ */
+void update_mpu_drift(const EncoderData* const encoders);
+
+/**
+ * @brief Samples the MPU-9250 sensor into the background gyro bias estimate.
+ * @param wheels_still Whether the encoders saw no motion since the last call.
+ * @note Meant to be called every millisecond while idle. Samples are only
+ * averaged after the wheels, the accelerometer and, once converged, the
+ * gyroscope have stayed still for a while.
+ */
+void update_mpu_bias(const bool wheels_still);
+
+/**
+ * @brief Checks whether the gyro bias estimate has enough samples.
+ * @return true once a full calibration worth of still samples was averaged.
+ */
+bool mpu_gyro_bias_converged(void);
+
+/**
+ * @brief Returns the gyroscope bias estimate, with its temperature model.
+ * @return Copy of the current estimate.
+ */
+GyroBias get_mpu_gyro_bias(void);
+
+/**
+ * @brief Replaces the gyroscope bias estimate, such as with a stored one.
+ * @param bias Estimate to use, taken as converged.
+ */
+void set_mpu_gyro_bias(const GyroBias* const bias);
+
+/**
+ * @brief Completes the gyroscope bias estimate of the MPU-9250 sensor.
+ * @note Returns at once if the background estimate already converged, and
+ * otherwise blocks only for the samples it is missing.
  */
 void mpu_calibrate_gyro(void);
 
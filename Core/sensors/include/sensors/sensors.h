@@ -15,9 +15,23 @@ const SensorState* init_sensors(void);
 /**
  * @brief Returns a pointer to the sensor state structure.
  * @return Pointer to the sensor state structure.
+ * @note The structure points to the front frame, published once an
+ * acquisition completes, so a new read never changes values mid-calculation.
+ * Only the control timer interrupt, and the foreground while the control
+ * timer is stopped, may read through the pointer, since every other publish
+ * happens with the control timer masked. Foreground code running alongside
+ * the control timer must take a copy with copy_sensor_frame().
  */
 const SensorState* get_sensors(void);
 
+/**
+ * @brief Copies the front frame for code outside the control interrupt.
+ * @param frame Buffer the frame is copied to.
+ * @note The control timer is masked during the copy, so foreground tasks
+ * still get a consistent frame however many the timer publishes meanwhile.
+ */
+void copy_sensor_frame(SensorFrame* const frame);
+
 /**
  * @brief Updates the sensor states struct by reading the hardware sensors.
  * @param timeout Timeout in microseconds for reading the sensors.
@@ -29,6 +43,21 @@ const SensorState* get_sensors(void);
  */
 void update_sensors(const uint16_t timeout, const bool read_encoder);
 
+/**
+ * @brief Updates the encoder data and publishes it in a new sensor frame.
+ * @note The control timer, whose sensor reads publish frames as well, and the
+ * SPI DMA, which writes the MPU data, are masked meanwhile.
+ */
+void update_encoder_sensors(void);
+
+/**
+ * @brief Samples the sensors in the background while the robot is idle.
+ * @note Keeps the gyro bias estimate converged, so runs can start without a
+ * blocking calibration. Samples are taken every millisecond, and only while
+ * the encoders show the wheels standing still.
+ */
+void update_idle_sensors(void);
+
 /**
  * @brief Clears the sensor readings, resetting them to default values.
  */
@@ -62,6 +91,8 @@ bool sensors_are_reading(void);
  * @return true if the sensors were updated, false if they are still being read.
  * @note Reading encoder data recalculates speeds based on the interval between
  * reads.
+ * @note The control timer and SPI DMA interrupts are masked while the frame is
+ * published, so it can be called from the foreground as well.
  */
 bool update_sensors_async(const bool read_encoder);
 
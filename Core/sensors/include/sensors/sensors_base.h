@@ -13,8 +13,25 @@ typedef struct {
     bool left_sensor;   // Flag to indicate if the left sensor is active.
     bool right_sensor;  // Flag to indicate if the right sensor is active.
     uint8_t total_central_sensors;  // Total number of central sensors.
+    uint16_t read_window_us;  // Current central sensor read window in us.
+    uint16_t white_us;  // Running average of line discharge times in us.
+    uint16_t black_us;  // Average background discharge in us, 0 if unseen.
 } IrSensorData;
 
+#define IR_CENTRAL_SENSORS 8  // Central sensors in calibrations and frames
+
+/**
+ * @struct IrCalibration
+ * @brief Structure to hold the per-sensor normalization of the IR sensors.
+ */
+typedef struct {
+    bool valid;                // Flag set once a calibration sweep succeeded
+    uint16_t read_timeout_us;  // Read window covering every threshold in us
+    uint16_t min_us[IR_CENTRAL_SENSORS];  // Fastest discharge (over line)
+    uint16_t max_us[IR_CENTRAL_SENSORS];  // Slowest discharge (background)
+    uint16_t threshold_us[IR_CENTRAL_SENSORS];  // Line below this time
+} IrCalibration;
+
 /**
  * @struct MpuData
  * @brief Structure to hold the MPU-9250 sensor data.
@@ -35,6 +52,18 @@ typedef struct {
     float roll;         // Roll angle in radians [-π, π]
 } MpuData;
 
+/**
+ * @struct GyroBias
+ * @brief Structure to hold the gyroscope bias estimate of the MPU-9250.
+ */
+typedef struct {
+    float x;      // Gyroscope bias in X-axis
+    float y;      // Gyroscope bias in Y-axis
+    float z;      // Gyroscope bias in Z-axis
+    float temp;   // Raw temperature the biases were estimated at
+    float slope;  // Z-axis bias change per degree Celsius
+} GyroBias;
+
 /**
  * @struct EncoderData
  * @brief Structure to hold the encoder values.
@@ -54,19 +83,47 @@ typedef struct {
     float right_speed;             // Speed of the right wheel in cm/s
     float speed;                   // Average speed of the robot in cm/s
     float current_interval;        // Time interval since last update in seconds
-    uint32_t last_update_time;     // Timestamp of the last update in ms
+    uint64_t last_update_time;     // Timestamp of the last update in us
     float effective_wheel_base;    // Effective wheel base value in cm
     float wheel_base_correction;   // Wheel base correction factor
 } EncoderData;
 
+/**
+ * @struct SidePulse
+ * @brief Structure to hold a completed pass of a side sensor over a marker.
+ */
+typedef struct {
+    uint8_t sensor;        // Side sensor index, 0 for left and 1 for right
+    bool overlapped;       // The other side sensor was active meanwhile
+    uint32_t start_us;     // Time the sensor got over the marker in us
+    uint32_t end_us;       // Time the sensor left the marker in us
+    float start_distance;  // Encoder distance at the start in cm
+    float length_mm;       // Distance traveled over the marker in mm
+} SidePulse;
+
+/**
+ * @struct SensorFrame
+ * @brief Structure to hold a snapshot of every peripheral sensor.
+ */
+typedef struct {
+    IrSensorData ir_sensors;  // Infrared sensor states
+    uint16_t ir_times_us[IR_CENTRAL_SENSORS];  // Discharge times in us
+    MpuData mpu_data;          // MPU sample
+    EncoderData encoders;      // Encoder counts and deltas
+    uint64_t ir_time_us;       // Start of the IR read window in us
+    uint64_t mpu_time_us;      // Time the MPU was sampled in us
+    uint64_t encoder_time_us;  // Time the encoders were sampled in us
+} SensorFrame;
+
 /**
  * @struct SensorState
  * @brief Structure to hold the state of the peripheral sensors.
+ * @note The frame is the front one, which stays unchanged until the next
+ * acquisition publishes the back frame in its place. A calculation takes the
+ * pointer once, so all of its values come from the same acquisition.
  */
 typedef struct {
-    const IrSensorData* ir_sensors;  // Pointer to the infrared sensor data
-    const MpuData* mpu_data;         // Pointer to the MPU data
-    const EncoderData* encoders;     // Pointer to the encoder data
+    const SensorFrame* frame;  // Pointer to the front frame
 } SensorState;
 
 #endif  // SENSORS_BASE_H
@@ -6,7 +6,13 @@
 
 #include "sensors/sensors_base.h"
 
-#define SENSOR_READ_TIMEOUT_US 300  // Timeout for sensor reading
+#define SENSOR_READ_TIMEOUT_US 300      // Timeout for sensor reading
+#define IR_CALIBRATION_TIMEOUT_US 1000  // Timeout for calibration reads
+
+/**
+ * @brief Initializes the interrupt capture of the central and side sensors.
+ */
+void init_ir_sensors(void);
 
 /**
  * @brief Returns a pointer to the sensor state structure.
@@ -45,6 +51,11 @@ void stop_ir_sensors_read(void);
  * @brief Checks if the sensors are currently being read.
  * @return true if the sensors are being read, false otherwise.
  * @note This function is meant to enable non-blocking sensor reading.
+ * @note Once calibrated, the read window only lasts up to the slowest
+ * per-sensor threshold instead of SENSOR_READ_TIMEOUT_US.
+ * @note Without a calibration, the window tracks halfway between the running
+ * averages of line and background discharge times, between a 100 us floor
+ * and the limit set with set_ir_window_limit().
  */
 bool ir_sensors_are_reading(void);
 
@@ -55,6 +66,48 @@ bool ir_sensors_are_reading(void);
  */
 bool update_ir_sensors_async(void);
 
+/**
+ * @brief Returns a pointer to the IR sensor calibration.
+ * @return Pointer to the calibration, only applied while its valid flag is set.
+ */
+const IrCalibration* get_ir_calibration(void);
+
+/**
+ * @brief Replaces the IR sensor calibration, such as with a stored one.
+ * @param restored Calibration to apply.
+ * @return true if it was applied, false if it is not valid for the current
+ * read window limits.
+ */
+bool set_ir_calibration(const IrCalibration* const restored);
+
+/**
+ * @brief Starts a new calibration sweep, clearing the recorded extremes.
+ * @note The current calibration stays in use until the sweep is finished.
+ */
+void start_ir_calibration(void);
+
+/**
+ * @brief Reads the sensors and records their fastest and slowest discharges.
+ * @note This function blocks for up to IR_CALIBRATION_TIMEOUT_US.
+ */
+void update_ir_calibration(void);
+
+/**
+ * @brief Finishes the calibration sweep, deriving the per-sensor thresholds
+ * and the read window from the recorded extremes.
+ * @return true if every sensor saw both the line and the background, false
+ * otherwise, in which case the previous calibration is kept.
+ */
+bool finish_ir_calibration(void);
+
+/**
+ * @brief Caps the adaptive read window, such as to fit a control frame.
+ * @param limit_us The longest window in microseconds, kept between 100 us
+ * and SENSOR_READ_TIMEOUT_US.
+ * @note A calibrated window is left as is.
+ */
+void set_ir_window_limit(const uint16_t limit_us);
+
 /**
  * @brief Gets the raw times from the central sensors.
  * @return Pointer to an array of raw sensor values.
@@ -17,7 +17,7 @@ static EncoderData encoder_data = {0};
 
 static int16_t left_encoder = 0;
 static int16_t right_encoder = 0;
-static uint32_t current_time = 0;
+static uint64_t current_time = 0;
 
 static inline void update_counters(void) {
     encoder_data.left_encoder += left_encoder;
@@ -49,7 +49,7 @@ static inline void update_angle(void) {
 
 static inline void update_speeds(void) {
     encoder_data.current_interval =
-        (current_time - encoder_data.last_update_time) / 1000.0f;
+        (float)(current_time - encoder_data.last_update_time) * 1e-6f;
     if (encoder_data.current_interval <= 0.0f) return;
 
     encoder_data.left_speed =
@@ -72,7 +72,7 @@ const EncoderData* get_encoder_data(void) { return &encoder_data; }
 void restart_encoders(void) { set_encoders(0); }
 
 void update_encoder_data(void) {
-    current_time = time();
+    current_time = time_us64();
 
     left_encoder = get_encoder_left();
     right_encoder = get_encoder_right();
@@ -86,8 +86,11 @@ void update_encoder_data(void) {
     encoder_data.last_update_time = current_time;
 }
 
-bool update_encoder_data_async(const uint32_t interval) {
-    if (!time_elapsed(encoder_data.last_update_time, interval)) return false;
+bool update_encoder_data_async(const uint32_t interval_ms) {
+    if (!time_elapsed_us64(encoder_data.last_update_time,
+                           interval_ms * US_PER_MS)) {
+        return false;
+    }
 
     update_encoder_data();
     return true;
@@ -102,7 +105,7 @@ void clear_encoder_data(void) {
 
     left_encoder = 0;
     right_encoder = 0;
-    current_time = time();
+    current_time = time_us64();
 }
 
 void start_encoders(void) {
@@ -0,0 +1,71 @@
+#include "sensors/markers.h"
+
+#include "hal/ir_sensors.h"
+
+#define S_PER_US 1e-6f
+#define MM_PER_CM 10.0f
+
+#define OTHER_SIDE(sensor) (TOTAL_SIDE_SENSORS - 1 - (sensor))
+
+static struct {
+    bool active;
+    bool overlapped;
+    uint32_t start_us;
+    float start_distance;
+} pulses[TOTAL_SIDE_SENSORS] = {0};
+
+static float get_distance_at(const SensorFrame* const frame,
+                             const uint32_t time) {
+    const int32_t elapsed = (int32_t)(time - (uint32_t)frame->encoder_time_us);
+
+    return frame->encoders.distance +
+           frame->encoders.speed * (float)elapsed * S_PER_US;
+}
+
+static void start_pulse(const SideSensorEdge* const edge,
+                        const SensorFrame* const frame) {
+    const uint8_t other = OTHER_SIDE(edge->sensor);
+
+    pulses[edge->sensor].active = true;
+    pulses[edge->sensor].overlapped = pulses[other].active;
+    pulses[edge->sensor].start_us = edge->time_us;
+    pulses[edge->sensor].start_distance = get_distance_at(frame, edge->time_us);
+
+    if (pulses[other].active) pulses[other].overlapped = true;
+}
+
+void clear_side_pulses(void) {
+    clear_side_edges();
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        pulses[i].active = false;
+    }
+}
+
+bool read_side_pulse(SidePulse* const pulse, const SensorFrame* const frame) {
+    SideSensorEdge edge;
+
+    while (read_side_edge(&edge)) {
+        if (edge.active) {
+            start_pulse(&edge, frame);
+            continue;
+        }
+
+        // Pulses already in progress when cleared are never reported
+        if (!pulses[edge.sensor].active) continue;
+        pulses[edge.sensor].active = false;
+
+        const float end_distance = get_distance_at(frame, edge.time_us);
+
+        pulse->sensor = edge.sensor;
+        pulse->overlapped = pulses[edge.sensor].overlapped;
+        pulse->start_us = pulses[edge.sensor].start_us;
+        pulse->end_us = edge.time_us;
+        pulse->start_distance = pulses[edge.sensor].start_distance;
+        pulse->length_mm = (end_distance - pulse->start_distance) * MM_PER_CM;
+
+        return true;
+    }
+
+    return false;
+}
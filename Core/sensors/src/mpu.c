@@ -1,5 +1,6 @@
 #include "sensors/mpu.h"
 
+#include <math.h>
 #include <stdint.h>
 
 #include "hal/spi.h"
@@ -16,40 +17,103 @@
 #define CALIBRATION_INTERVAL 1.0f  // ms
 #define CALIBRATION_SAMPLES 3000
 
+#define BIAS_SETTLE_SAMPLES 200  // Still samples skipped before averaging
+#define ACCEL_STILL_LSB 400.0f   // ~0.025 g off the mean acceleration
+#define GYRO_STILL_LSB 33.0f     // ~2 deg/s off a converged bias
+#define ACCEL_MEAN_SHIFT 4       // Acceleration mean EMA weight, 1/16
+
+#define TEMP_LSB_PER_DEG 333.87f
+#define DRIFT_WINDOW_SAMPLES 100    // Gyro samples per slip check
+#define DRIFT_MIN_SEGMENT_SAMPLES 1000  // Shorter straights are dropped
+#define DRIFT_MAX_SEGMENT_SAMPLES 5000  // Gyro samples per bias observation
+#define DRIFT_STRAIGHT_ANGLE 0.1f   // rad, larger turns end the segment
+#define DRIFT_SLIP_ANGLE 0.006f     // rad per window, two encoder pulses
+#define DRIFT_ANGLE_NOISE 0.002f    // rad, encoder quantization per segment
+#define DRIFT_BIAS_VARIANCE 0.04f   // LSB^2, bias left by the idle estimate
+#define DRIFT_BIAS_NOISE 0.0001f    // LSB^2 per observation
+#define DRIFT_SLOPE_VARIANCE 4.0f   // (LSB/deg C)^2, before any observation
+#define DRIFT_INNOVATION_GATE 25.0f  // Squared sigmas, slow slips are rejected
+#define DRIFT_SHIFT_GATE 9.0f       // Squared sigmas a bias must move to apply
+
+// Past this the FIFO may have dropped part of a sample
+#define FIFO_FULL_BYTES (FIFO_SIZE - FIFO_SAMPLE_SIZE)
+
+typedef enum {
+    MPU_READ_COUNT,    // Reading how many bytes the FIFO holds
+    MPU_READ_SAMPLES,  // Draining the queued samples
+} MpuReadStage;
+
 static MpuData mpu_data = {0};
-static uint8_t mpu_data_values[TOTAL_REGISTERS] = {0};
+static uint8_t mpu_data_values[SPI_MAX_READ] = {0};
 
 static float pv_gyro_x = 0;
 static float pv_gyro_y = 0;
 static float pv_gyro_z = 0;
 static bool integrators_initialized = false;
-static uint32_t last_update_time = 0;
-static uint32_t current_time = 0;
+static uint64_t current_time = 0;
+
+static uint16_t bias_samples = 0;
+static uint16_t still_samples = 0;
+static bool accel_mean_initialized = false;
+static float mean_accel_x = 0;
+static float mean_accel_y = 0;
+static float mean_accel_z = 0;
+static float bias_temp = 0;
+
+// Yaw bias model, bias_gyro_z = drift_bias + drift_slope * (temp - drift_temp)
+static bool drift_tracking = false;
+static float drift_idle_bias = 0;
+static float drift_bias = 0;
+static float drift_slope = 0;
+static float drift_temp = 0;
+static float drift_p[2][2] = {{0}};
+
+// Filled from the SPI DMA callback, taken with every encoder update
+static float drift_gyro_sum = 0;
+static float drift_temp_sum = 0;
+static uint16_t drift_gyro_samples = 0;
+
+// Straight driving since the last observation, checked for slips by windows
+static float segment_gyro_sum = 0;
+static float segment_temp_sum = 0;
+static float segment_angle = 0;
+static uint16_t segment_samples = 0;
+
+static float window_gyro_sum = 0;
+static float window_temp_sum = 0;
+static float window_angle = 0;
+static uint16_t window_samples = 0;
+
+static volatile bool dma_reading = false;
+static uint64_t dma_read_time = 0;
+static MpuReadStage read_stage = MPU_READ_COUNT;
+static uint8_t batch_samples = 0;
+
+static inline void parse_readings(const uint8_t* const values) {
+    mpu_data.accel_x =
+        (int16_t)(((uint16_t)values[0] << 8) | (uint16_t)values[1]);
+    mpu_data.accel_y =
+        (int16_t)(((uint16_t)values[2] << 8) | (uint16_t)values[3]);
+    mpu_data.accel_z =
+        (int16_t)(((uint16_t)values[4] << 8) | (uint16_t)values[5]);
+
+    mpu_data.temp = (int16_t)(((uint16_t)values[6] << 8) | (uint16_t)values[7]);
+
+    mpu_data.gyro_x =
+        (int16_t)(((uint16_t)values[8] << 8) | (uint16_t)values[9]);
+    mpu_data.gyro_y =
+        (int16_t)(((uint16_t)values[10] << 8) | (uint16_t)values[11]);
+    mpu_data.gyro_z =
+        (int16_t)(((uint16_t)values[12] << 8) | (uint16_t)values[13]);
+}
 
 static inline void update_readings(void) {
     read_registers(ACCEL_REG_X, mpu_data_values, TOTAL_REGISTERS);
-
-    mpu_data.accel_x = (int16_t)(((uint16_t)mpu_data_values[0] << 8) |
-                                 (uint16_t)mpu_data_values[1]);
-    mpu_data.accel_y = (int16_t)(((uint16_t)mpu_data_values[2] << 8) |
-                                 (uint16_t)mpu_data_values[3]);
-    mpu_data.accel_z = (int16_t)(((uint16_t)mpu_data_values[4] << 8) |
-                                 (uint16_t)mpu_data_values[5]);
-
-    mpu_data.temp = (int16_t)(((uint16_t)mpu_data_values[6] << 8) |
-                              (uint16_t)mpu_data_values[7]);
-
-    mpu_data.gyro_x = (int16_t)(((uint16_t)mpu_data_values[8] << 8) |
-                                (uint16_t)mpu_data_values[9]);
-    mpu_data.gyro_y = (int16_t)(((uint16_t)mpu_data_values[10] << 8) |
-                                (uint16_t)mpu_data_values[11]);
-    mpu_data.gyro_z = (int16_t)(((uint16_t)mpu_data_values[12] << 8) |
-                                (uint16_t)mpu_data_values[13]);
-
-    current_time = time_us();
+    parse_readings(mpu_data_values);
+    current_time = time_us64();
 }
 
-static inline void update_angles(void) {
+static inline void integrate_angles(const float dt) {
     const float gyro_x = (float)mpu_data.gyro_x - mpu_data.bias_gyro_x;
     const float gyro_y = (float)mpu_data.gyro_y - mpu_data.bias_gyro_y;
     const float gyro_z = (float)mpu_data.gyro_z - mpu_data.bias_gyro_z;
@@ -58,13 +122,10 @@ static inline void update_angles(void) {
         pv_gyro_x = gyro_x;
         pv_gyro_y = gyro_y;
         pv_gyro_z = gyro_z;
-        last_update_time = current_time;
         integrators_initialized = true;
         return;
     }
 
-    const float dt =
-        (float)(current_time - last_update_time) * 1e-6f * RAD_PER_SEC;
     if (dt <= 0.0f) return;
 
     mpu_data.roll += 0.5f * (gyro_x + pv_gyro_x) * dt;
@@ -78,7 +139,254 @@ static inline void update_angles(void) {
     pv_gyro_x = gyro_x;
     pv_gyro_y = gyro_y;
     pv_gyro_z = gyro_z;
-    last_update_time = current_time;
+}
+
+static void finish_dma_read(void) {
+    read_stage = MPU_READ_COUNT;
+    dma_reading = false;
+}
+
+static uint8_t get_fifo_batch(const uint8_t* const count_data) {
+    const uint16_t count =
+        ((uint16_t)count_data[0] << 8) | (uint16_t)count_data[1];
+
+    // A full FIFO stops taking samples, so start over from fresh ones
+    if (count > FIFO_FULL_BYTES) {
+        reset_fifo();
+        return 0;
+    }
+
+    // Samples left over are drained with the next read
+    const uint16_t samples = count / FIFO_SAMPLE_SIZE;
+    return samples > FIFO_MAX_BATCH ? FIFO_MAX_BATCH : (uint8_t)samples;
+}
+
+static void integrate_fifo_samples(const uint8_t* const data,
+                                   const uint8_t samples,
+                                   const uint64_t time_us) {
+    // Samples are queued at the sample rate, whatever the read rate is
+    for (uint8_t i = 0; i < samples; i++) {
+        parse_readings(&data[i * FIFO_SAMPLE_SIZE]);
+        integrate_angles(STD_RAD_PER_LBS);
+
+        drift_gyro_sum += (float)mpu_data.gyro_z;
+        drift_temp_sum += (float)mpu_data.temp;
+        if (drift_gyro_samples < UINT16_MAX) drift_gyro_samples++;
+    }
+
+    current_time = time_us;
+}
+
+static void handle_fifo_count(const uint8_t* const data) {
+    batch_samples = get_fifo_batch(data);
+    if (batch_samples == 0) {
+        finish_dma_read();
+        return;
+    }
+
+    // Set before starting, the callback may run before the call returns
+    read_stage = MPU_READ_SAMPLES;
+    if (!start_registers_read(FIFO_REG, batch_samples * FIFO_SAMPLE_SIZE)) {
+        finish_dma_read();
+    }
+}
+
+static void handle_fifo_samples(const uint8_t* const data) {
+    integrate_fifo_samples(data, batch_samples, dma_read_time);
+    finish_dma_read();
+}
+
+static void handle_dma_read(const uint8_t* const data) {
+    if (read_stage == MPU_READ_COUNT) {
+        handle_fifo_count(data);
+    } else {
+        handle_fifo_samples(data);
+    }
+}
+
+static void add_bias_sample(void) {
+    if (bias_samples < CALIBRATION_SAMPLES) bias_samples++;
+
+    // Running mean, which becomes a moving average once converged
+    const float weight = 1.0f / (float)bias_samples;
+    mpu_data.bias_gyro_x += ((float)mpu_data.gyro_x - mpu_data.bias_gyro_x) *
+                            weight;
+    mpu_data.bias_gyro_y += ((float)mpu_data.gyro_y - mpu_data.bias_gyro_y) *
+                            weight;
+    mpu_data.bias_gyro_z += ((float)mpu_data.gyro_z - mpu_data.bias_gyro_z) *
+                            weight;
+    bias_temp += ((float)mpu_data.temp - bias_temp) * weight;
+}
+
+static bool is_accel_still(void) {
+    const float accel_x = (float)mpu_data.accel_x;
+    const float accel_y = (float)mpu_data.accel_y;
+    const float accel_z = (float)mpu_data.accel_z;
+
+    if (!accel_mean_initialized) {
+        mean_accel_x = accel_x;
+        mean_accel_y = accel_y;
+        mean_accel_z = accel_z;
+        accel_mean_initialized = true;
+    }
+
+    const float deviation = fabsf(accel_x - mean_accel_x) +
+                            fabsf(accel_y - mean_accel_y) +
+                            fabsf(accel_z - mean_accel_z);
+
+    const float weight = 1.0f / (float)(1 << ACCEL_MEAN_SHIFT);
+    mean_accel_x += (accel_x - mean_accel_x) * weight;
+    mean_accel_y += (accel_y - mean_accel_y) * weight;
+    mean_accel_z += (accel_z - mean_accel_z) * weight;
+
+    return deviation < ACCEL_STILL_LSB;
+}
+
+static bool is_gyro_still(void) {
+    // Any rate looks like a bias until one has been measured
+    if (!mpu_gyro_bias_converged()) return true;
+
+    return fabsf((float)mpu_data.gyro_x - mpu_data.bias_gyro_x) <
+               GYRO_STILL_LSB &&
+           fabsf((float)mpu_data.gyro_y - mpu_data.bias_gyro_y) <
+               GYRO_STILL_LSB &&
+           fabsf((float)mpu_data.gyro_z - mpu_data.bias_gyro_z) <
+               GYRO_STILL_LSB;
+}
+
+static void reset_bias_estimate(void) {
+    bias_samples = 0;
+    still_samples = 0;
+    accel_mean_initialized = false;
+    bias_temp = 0;
+}
+
+static void reset_drift_window(void) {
+    window_gyro_sum = 0;
+    window_temp_sum = 0;
+    window_angle = 0;
+    window_samples = 0;
+}
+
+static void reset_drift_segment(void) {
+    segment_gyro_sum = 0;
+    segment_temp_sum = 0;
+    segment_angle = 0;
+    segment_samples = 0;
+}
+
+static void start_drift_tracking(void) {
+    drift_tracking = mpu_gyro_bias_converged();
+    drift_idle_bias = mpu_data.bias_gyro_z;
+    drift_bias = mpu_data.bias_gyro_z;
+    drift_temp = bias_temp;
+
+    // The temperature slope belongs to the sensor, so it is kept between runs
+    drift_p[0][0] = DRIFT_BIAS_VARIANCE;
+    drift_p[0][1] = 0;
+    drift_p[1][0] = 0;
+    if (drift_p[1][1] <= 0.0f) drift_p[1][1] = DRIFT_SLOPE_VARIANCE;
+
+    drift_gyro_sum = 0;
+    drift_temp_sum = 0;
+    drift_gyro_samples = 0;
+    reset_drift_window();
+    reset_drift_segment();
+}
+
+static inline float get_drift_temp_delta(const float temp) {
+    return (temp - drift_temp) / TEMP_LSB_PER_DEG;
+}
+
+static inline float get_drift_bias(const float temp) {
+    return drift_bias + drift_slope * get_drift_temp_delta(temp);
+}
+
+static bool is_drift_trusted(const float temp) {
+    const float temp_delta = get_drift_temp_delta(temp);
+    const float variance = drift_p[0][0] +
+                           2.0f * drift_p[0][1] * temp_delta +
+                           drift_p[1][1] * temp_delta * temp_delta;
+
+    // The idle estimate ignores the temperature, so it worsens as that moves
+    const float idle_variance =
+        DRIFT_BIAS_VARIANCE + DRIFT_SLOPE_VARIANCE * temp_delta * temp_delta;
+    if (variance >= idle_variance) return false;
+
+    // Noise alone moves the model too, so only a clear shift from the idle
+    // estimate replaces it
+    const float shift = get_drift_bias(temp) - drift_idle_bias;
+    return shift * shift > DRIFT_SHIFT_GATE * variance;
+}
+
+static void update_drift_model(const float observed_bias,
+                               const float temp_delta, const float noise) {
+    drift_p[0][0] += DRIFT_BIAS_NOISE;
+
+    // Observation model is drift_bias + drift_slope * temp_delta
+    const float ph0 = drift_p[0][0] + drift_p[0][1] * temp_delta;
+    const float ph1 = drift_p[1][0] + drift_p[1][1] * temp_delta;
+    const float innovation_variance = ph0 + ph1 * temp_delta + noise;
+    const float innovation =
+        observed_bias - (drift_bias + drift_slope * temp_delta);
+
+    if (innovation * innovation >
+        DRIFT_INNOVATION_GATE * innovation_variance) {
+        return;
+    }
+
+    const float k0 = ph0 / innovation_variance;
+    const float k1 = ph1 / innovation_variance;
+    drift_bias += k0 * innovation;
+    drift_slope += k1 * innovation;
+
+    const float p00 = drift_p[0][0] - k0 * ph0;
+    const float p01 = drift_p[0][1] - k0 * ph1;
+    const float p11 = drift_p[1][1] - k1 * ph1;
+    drift_p[0][0] = p00;
+    drift_p[0][1] = p01;
+    drift_p[1][0] = p01;
+    drift_p[1][1] = p11;
+}
+
+static void observe_drift_segment(void) {
+    if (segment_samples < DRIFT_MIN_SEGMENT_SAMPLES) return;
+    const float samples = (float)segment_samples;
+
+    // On a straight the encoders leave almost no rotation to the gyro, so
+    // what it measured beyond theirs is bias
+    const float encoder_rate = segment_angle / (samples * STD_RAD_PER_LBS);
+    const float observed_bias = segment_gyro_sum / samples - encoder_rate;
+
+    const float angle_noise = DRIFT_ANGLE_NOISE / (samples * STD_RAD_PER_LBS);
+    const float temp_delta = get_drift_temp_delta(segment_temp_sum / samples);
+    update_drift_model(observed_bias, temp_delta, angle_noise * angle_noise);
+}
+
+static void end_drift_segment(void) {
+    observe_drift_segment();
+    reset_drift_segment();
+}
+
+static void check_drift_window(void) {
+    const float samples = (float)window_samples;
+    const float bias = get_drift_bias(window_temp_sum / samples);
+    const float gyro_angle =
+        (window_gyro_sum - bias * samples) * STD_RAD_PER_LBS;
+
+    // A wheel slip shows up as a sudden disagreement, and keeps the window
+    // out of the segment. A steady one is a bias, left to the model.
+    if (fabsf(gyro_angle - window_angle) > DRIFT_SLIP_ANGLE ||
+        fabsf(segment_angle + window_angle) > DRIFT_STRAIGHT_ANGLE) {
+        end_drift_segment();
+        return;
+    }
+
+    segment_gyro_sum += window_gyro_sum;
+    segment_temp_sum += window_temp_sum;
+    segment_angle += window_angle;
+    segment_samples += window_samples;
+    if (segment_samples >= DRIFT_MAX_SEGMENT_SAMPLES) end_drift_segment();
 }
 
 bool init_mpu(void) {
@@ -89,16 +397,110 @@ bool init_mpu(void) {
         return false;
     }
 
-    mpu_calibrate_gyro();
+    init_spi_dma(handle_dma_read);
     debug_print("MPU initialized successfully");
     return true;
 }
 
 const MpuData* get_mpu_data(void) { return &mpu_data; }
 
+uint64_t get_mpu_time_us(void) { return current_time; }
+
 void update_mpu_data(void) {
+    uint8_t count_data[2];
+    read_registers(FIFO_COUNT_REG, count_data, sizeof(count_data));
+
+    const uint8_t samples = get_fifo_batch(count_data);
+    if (samples == 0) return;
+
+    read_registers(FIFO_REG, mpu_data_values, samples * FIFO_SAMPLE_SIZE);
+    integrate_fifo_samples(mpu_data_values, samples, time_us64());
+}
+
+void update_mpu_drift(const EncoderData* const encoders) {
+    const float gyro_sum = drift_gyro_sum;
+    const float temp_sum = drift_temp_sum;
+    const uint16_t samples = drift_gyro_samples;
+    drift_gyro_sum = 0;
+    drift_temp_sum = 0;
+    drift_gyro_samples = 0;
+
+    if (!drift_tracking) return;
+
+    window_gyro_sum += gyro_sum;
+    window_temp_sum += temp_sum;
+    window_angle += encoders->current_angle;
+    window_samples += samples;
+
+    if (window_samples >= DRIFT_WINDOW_SAMPLES) {
+        check_drift_window();
+        reset_drift_window();
+    }
+
+    // The idle estimate is kept until the model is more certain than it, then
+    // the bias follows the temperature of the latest samples
+    if (samples == 0) return;
+    const float temp = temp_sum / (float)samples;
+    mpu_data.bias_gyro_z =
+        is_drift_trusted(temp) ? get_drift_bias(temp) : drift_idle_bias;
+}
+
+void update_mpu_bias(const bool wheels_still) {
     update_readings();
-    update_angles();
+
+    // Both checks run every sample to keep the acceleration mean current
+    const bool accel_still = is_accel_still();
+    const bool gyro_still = is_gyro_still();
+
+    if (!wheels_still || !accel_still || !gyro_still) {
+        still_samples = 0;
+        return;
+    }
+
+    // Skip the samples right after moving, the robot may still be settling
+    if (still_samples < BIAS_SETTLE_SAMPLES) {
+        still_samples++;
+        return;
+    }
+
+    add_bias_sample();
+}
+
+bool mpu_gyro_bias_converged(void) {
+    return bias_samples >= CALIBRATION_SAMPLES;
+}
+
+GyroBias get_mpu_gyro_bias(void) {
+    return (GyroBias){
+        .x = mpu_data.bias_gyro_x,
+        .y = mpu_data.bias_gyro_y,
+        .z = mpu_data.bias_gyro_z,
+        .temp = bias_temp,
+        .slope = drift_slope,
+    };
+}
+
+void set_mpu_gyro_bias(const GyroBias* const bias) {
+    mpu_data.bias_gyro_x = bias->x;
+    mpu_data.bias_gyro_y = bias->y;
+    mpu_data.bias_gyro_z = bias->z;
+    bias_temp = bias->temp;
+    drift_slope = bias->slope;
+
+    // Idle samples keep refining it as a moving average
+    bias_samples = CALIBRATION_SAMPLES;
+}
+
+bool start_mpu_read(const uint64_t time_us) {
+    if (dma_reading) return false;
+
+    // Set before starting, the callback may run before the call returns
+    dma_reading = true;
+    dma_read_time = time_us;
+    if (start_registers_read(FIFO_COUNT_REG, 2)) return true;
+
+    finish_dma_read();
+    return false;
 }
 
 void clear_mpu_data(void) {
@@ -107,9 +509,13 @@ void clear_mpu_data(void) {
     pv_gyro_x = 0;
     pv_gyro_y = 0;
     pv_gyro_z = 0;
-    last_update_time = 0;
     current_time = 0;
     integrators_initialized = false;
+    reset_bias_estimate();
+
+    drift_tracking = false;
+    drift_slope = 0;
+    drift_p[1][1] = 0;
 }
 
 void restart_mpu(void) {
@@ -127,38 +533,31 @@ void restart_mpu(void) {
     pv_gyro_x = 0;
     pv_gyro_y = 0;
     pv_gyro_z = 0;
-    last_update_time = 0;
     current_time = 0;
     integrators_initialized = false;
+
+    // Drop the samples queued while the angles were not integrated
+    reset_fifo();
+    start_drift_tracking();
 }
 
 void mpu_calibrate_gyro(void) {
-    debug_print("Calibrating MPU gyroscope");
+    if (mpu_gyro_bias_converged()) return;
 
-    float sum_gyro_x = 0;
-    float sum_gyro_y = 0;
-    float sum_gyro_z = 0;
+    debug_print("Calibrating MPU gyroscope");
 
-    uint16_t sampled = 0;
+    // Only the samples the background estimate is missing are taken
     uint32_t sample_time = 0;
-    while (sampled < CALIBRATION_SAMPLES) {
+    while (!mpu_gyro_bias_converged()) {
         if (!time_elapsed(sample_time, CALIBRATION_INTERVAL)) continue;
 
         sample_time = time();
         update_readings();
-
-        sum_gyro_x += (float)mpu_data.gyro_x;
-        sum_gyro_y += (float)mpu_data.gyro_y;
-        sum_gyro_z += (float)mpu_data.gyro_z;
-        sampled++;
+        add_bias_sample();
 
         process_serial_messages();
     }
 
-    mpu_data.bias_gyro_x = sum_gyro_x / (float)CALIBRATION_SAMPLES;
-    mpu_data.bias_gyro_y = sum_gyro_y / (float)CALIBRATION_SAMPLES;
-    mpu_data.bias_gyro_z = sum_gyro_z / (float)CALIBRATION_SAMPLES;
-
     debug_print("Finished MPU gyroscope calibration.");
     debug_print_mpu_gyroscope_biases();
 
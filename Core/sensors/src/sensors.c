@@ -1,43 +1,118 @@
 #include "sensors/sensors.h"
 
 #include <stdlib.h>
+#include <string.h>
 
+#include "hal/control_timer.h"
+#include "hal/spi.h"
 #include "sensors/encoder.h"
+#include "sensors/markers.h"
 #include "sensors/mpu.h"
 #include "sensors/vision.h"
+#include "timer/time.h"
+
+#define SENSOR_FRAMES 2  // Front frame read by controllers, back one written
+#define IDLE_SAMPLE_PERIOD_US 1000  // Gyro bias sampling while idle
+
+static SensorFrame frames[SENSOR_FRAMES] = {0};
+static uint8_t back_frame = 0;
+
+static uint64_t ir_time_us = 0;
+static uint64_t idle_sample_time_us = 0;
 
 static SensorState sensors = {
-    .ir_sensors = NULL,
-    .mpu_data = NULL,
-    .encoders = NULL,
+    .frame = NULL,
 };
 
+// Acquisitions publish through publish_sensors(), which masks its writers
+static void publish_frame(void) {
+    SensorFrame* const frame = &frames[back_frame];
+
+    frame->ir_sensors = *get_ir_sensors();
+    memcpy(frame->ir_times_us, get_central_ir_sensor_times(),
+           sizeof(frame->ir_times_us));
+    frame->mpu_data = *get_mpu_data();
+    frame->encoders = *get_encoder_data();
+
+    frame->ir_time_us = ir_time_us;
+    frame->mpu_time_us = get_mpu_time_us();
+    frame->encoder_time_us = frame->encoders.last_update_time;
+
+    sensors.frame = frame;
+
+    back_frame = (back_frame + 1) % SENSOR_FRAMES;
+}
+
+// The control timer publishes frames too, and the SPI DMA callback writes the
+// MPU data and gyro sums read here. Masking both is harmless from the timer.
+static void publish_sensors(const bool read_encoder) {
+    mask_control_timer();
+    mask_spi_dma();
+
+    if (read_encoder) {
+        update_encoder_data();
+        update_mpu_drift(get_encoder_data());
+    }
+    publish_frame();
+
+    unmask_spi_dma();
+    unmask_control_timer();
+}
+
 const SensorState* init_sensors(void) {
     init_mpu();
     init_encoder();
+    init_ir_sensors();
 
-    sensors.ir_sensors = get_ir_sensors();
-    sensors.mpu_data = get_mpu_data();
-    sensors.encoders = get_encoder_data();
-
+    publish_frame();
     return &sensors;
 }
 
 const SensorState* get_sensors(void) { return &sensors; }
 
+void copy_sensor_frame(SensorFrame* const frame) {
+    // Two publishes during a slow copy would rewrite the frame being copied
+    mask_control_timer();
+    *frame = *sensors.frame;
+    unmask_control_timer();
+}
+
 void update_sensors(const uint16_t timeout, const bool read_encoder) {
+    ir_time_us = time_us64();
     update_ir_sensors(timeout);
     update_mpu_data();
-    if (read_encoder) update_encoder_data();
+    publish_sensors(read_encoder);
+}
+
+void update_encoder_sensors(void) { publish_sensors(true); }
+
+void update_idle_sensors(void) {
+    if (!time_elapsed_us64(idle_sample_time_us, IDLE_SAMPLE_PERIOD_US)) return;
+    idle_sample_time_us = time_us64();
+
+    update_encoder_data();
+    const EncoderData* const encoders = get_encoder_data();
+    const bool wheels_still = encoders->current_left_distance == 0.0f &&
+                              encoders->current_right_distance == 0.0f;
+
+    update_mpu_bias(wheels_still);
 }
 
 void clear_sensors(void) {
     clear_ir_sensors();
     clear_mpu_data();
     clear_encoder_data();
+
+    publish_frame();
 }
 
-void start_async_sensors_read(void) { start_ir_sensors_read(); }
+void start_async_sensors_read(void) {
+    ir_time_us = time_us64();
+    start_ir_sensors_read();
+
+    // The MPU burst runs over DMA while the IR sensors discharge
+    start_mpu_read(ir_time_us);
+}
 
 void stop_async_sensors_read(void) { stop_ir_sensors_read(); }
 
@@ -46,13 +121,15 @@ bool sensors_are_reading(void) { return ir_sensors_are_reading(); }
 bool update_sensors_async(const bool read_encoder) {
     if (!update_ir_sensors_async()) return false;
 
-    update_mpu_data();
-    if (read_encoder) update_encoder_data();
+    publish_sensors(read_encoder);
     return true;
 }
 
 void restart_sensors(void) {
     clear_ir_sensors();
+    clear_side_pulses();
     start_encoders();
     restart_mpu();
+
+    publish_frame();
 }
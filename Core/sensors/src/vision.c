@@ -2,18 +2,137 @@
 
 #include "hal/ir_sensors.h"
 
-static IrSensorData sensors = {0, false, false, TOTAL_CENTRAL_SENSORS};
+#define IR_CALIBRATION_MIN_CONTRAST_US 40  // Spread needed to find the line
 
-const IrSensorData* get_ir_sensors(void) { return &sensors; }
+#define IR_WINDOW_MIN_US 100          // Shortest adaptive read window
+#define IR_WINDOW_AVERAGE_SHIFT 4     // New samples weigh 1/16 in the averages
+#define IR_WINDOW_CENSOR_MARGIN_US 5  // Times this near the window timed out
+#define IR_WINDOW_LOST_FRAMES 50      // Reads without the line before a reset
 
-void update_ir_sensors(const uint16_t timeout) {
-    sensors.central_sensors_state = read_central_sensors(timeout);
+_Static_assert(IR_CENTRAL_SENSORS == TOTAL_CENTRAL_SENSORS,
+               "IR calibrations and frames must cover every central sensor");
+
+static IrSensorData sensors = {
+    .central_sensors_state = 0,
+    .left_sensor = false,
+    .right_sensor = false,
+    .total_central_sensors = TOTAL_CENTRAL_SENSORS,
+    .read_window_us = SENSOR_READ_TIMEOUT_US,
+    .white_us = 0,
+    .black_us = 0,
+};
+
+static IrCalibration calibration = {
+    .valid = false,
+    .read_timeout_us = SENSOR_READ_TIMEOUT_US,
+};
+
+// Longest adaptive window, the control frame leaves no time for more
+static uint16_t window_limit_us = SENSOR_READ_TIMEOUT_US;
+
+static uint16_t sweep_min_us[TOTAL_CENTRAL_SENSORS] = {0};
+static uint16_t sweep_max_us[TOTAL_CENTRAL_SENSORS] = {0};
+
+static uint32_t white_sum = 0;
+static uint32_t black_sum = 0;
+static uint8_t lost_frames = 0;
+
+static uint8_t get_calibrated_state(void) {
+    const uint16_t* const times = get_central_sensor_values();
+    uint8_t state = 0;
 
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (times[i] < calibration.threshold_us[i]) state |= (1 << i);
+    }
+
+    return state;
+}
+
+static inline void update_central_sensors_state(const uint8_t raw_state) {
+    sensors.central_sensors_state =
+        calibration.valid ? get_calibrated_state() : raw_state;
+}
+
+static inline void update_side_sensors(void) {
     const bool* side_sensors = get_side_sensor_values();
     sensors.left_sensor = side_sensors[0];
     sensors.right_sensor = side_sensors[1];
 }
 
+static void update_average(uint32_t* const sum, uint16_t* const average,
+                           const uint16_t sample) {
+    // The first sample seeds the average instead of ramping up from zero
+    if (*average == 0) {
+        *sum = (uint32_t)sample << IR_WINDOW_AVERAGE_SHIFT;
+    } else {
+        *sum = *sum - (*sum >> IR_WINDOW_AVERAGE_SHIFT) + sample;
+    }
+
+    *average = (uint16_t)(*sum >> IR_WINDOW_AVERAGE_SHIFT);
+}
+
+static void reset_read_window(void) {
+    sensors.read_window_us = window_limit_us;
+    sensors.white_us = 0;
+    sensors.black_us = 0;
+    lost_frames = 0;
+}
+
+static void adapt_read_window(void) {
+    const uint16_t* const times = get_central_sensor_values();
+    const uint16_t timed_out =
+        sensors.read_window_us - IR_WINDOW_CENSOR_MARGIN_US;
+
+    uint16_t fastest = UINT16_MAX;
+    uint16_t slowest = 0;
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (times[i] < fastest) fastest = times[i];
+        if (times[i] > slowest) slowest = times[i];
+    }
+
+    // Losing the line for long may mean the line got slower than the window
+    if (fastest >= timed_out) {
+        if (++lost_frames >= IR_WINDOW_LOST_FRAMES) reset_read_window();
+        return;
+    }
+
+    lost_frames = 0;
+    update_average(&white_sum, &sensors.white_us, fastest);
+
+    // Only background that discharged within the window can be measured
+    if (slowest < timed_out &&
+        slowest >= fastest + IR_CALIBRATION_MIN_CONTRAST_US) {
+        update_average(&black_sum, &sensors.black_us, slowest);
+    }
+
+    if (sensors.black_us == 0) return;
+
+    if (sensors.black_us < sensors.white_us + IR_CALIBRATION_MIN_CONTRAST_US) {
+        reset_read_window();
+        return;
+    }
+
+    // Split line and background halfway, like a calibrated threshold would
+    uint16_t window = (sensors.white_us + sensors.black_us) / 2;
+    if (window < IR_WINDOW_MIN_US) window = IR_WINDOW_MIN_US;
+    if (window > window_limit_us) window = window_limit_us;
+
+    sensors.read_window_us = window;
+}
+
+void init_ir_sensors(void) {
+    init_ir_capture();
+    init_side_capture();
+}
+
+const IrSensorData* get_ir_sensors(void) { return &sensors; }
+
+void update_ir_sensors(const uint16_t timeout) {
+    update_central_sensors_state(read_central_sensors(timeout));
+    update_side_sensors();
+}
+
 void clear_ir_sensors(void) {
     sensors.central_sensors_state = 0;
     sensors.left_sensor = false;
@@ -25,21 +144,100 @@ void start_ir_sensors_read(void) { start_read(); }
 void stop_ir_sensors_read(void) { stop_read(); }
 
 bool ir_sensors_are_reading(void) {
-    return central_sensor_is_reading(SENSOR_READ_TIMEOUT_US);
+    return central_sensor_is_reading(sensors.read_window_us);
 }
 
 bool update_ir_sensors_async(void) {
-    if (central_sensor_is_reading(SENSOR_READ_TIMEOUT_US)) return false;
-
-    sensors.central_sensors_state = read_central_sensors_async();
+    if (central_sensor_is_reading(sensors.read_window_us)) return false;
 
-    const bool* side_sensors = get_side_sensor_values();
-    sensors.left_sensor = side_sensors[0];
-    sensors.right_sensor = side_sensors[1];
+    update_central_sensors_state(read_central_sensors_async());
+    update_side_sensors();
+    if (!calibration.valid) adapt_read_window();
 
     return true;
 }
 
+void set_ir_window_limit(const uint16_t limit_us) {
+    window_limit_us = limit_us;
+    if (window_limit_us < IR_WINDOW_MIN_US) window_limit_us = IR_WINDOW_MIN_US;
+    if (window_limit_us > SENSOR_READ_TIMEOUT_US) {
+        window_limit_us = SENSOR_READ_TIMEOUT_US;
+    }
+
+    if (!calibration.valid && sensors.read_window_us > window_limit_us) {
+        sensors.read_window_us = window_limit_us;
+    }
+}
+
 const uint16_t* get_central_ir_sensor_times(void) {
     return get_central_sensor_values();
 }
+
+const IrCalibration* get_ir_calibration(void) { return &calibration; }
+
+bool set_ir_calibration(const IrCalibration* const restored) {
+    if (!restored->valid ||
+        restored->read_timeout_us > SENSOR_READ_TIMEOUT_US) {
+        return false;
+    }
+
+    // The analog error divides by each sensor's range
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (restored->threshold_us[i] > restored->read_timeout_us ||
+            restored->max_us[i] <
+                restored->min_us[i] + IR_CALIBRATION_MIN_CONTRAST_US) {
+            return false;
+        }
+    }
+
+    calibration = *restored;
+    sensors.read_window_us = calibration.read_timeout_us;
+    return true;
+}
+
+void start_ir_calibration(void) {
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        sweep_min_us[i] = UINT16_MAX;
+        sweep_max_us[i] = 0;
+    }
+}
+
+void update_ir_calibration(void) {
+    (void)read_central_sensors(IR_CALIBRATION_TIMEOUT_US);
+    const uint16_t* const times = get_central_sensor_values();
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (times[i] < sweep_min_us[i]) sweep_min_us[i] = times[i];
+        if (times[i] > sweep_max_us[i]) sweep_max_us[i] = times[i];
+    }
+}
+
+bool finish_ir_calibration(void) {
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        if (sweep_max_us[i] <
+            sweep_min_us[i] + IR_CALIBRATION_MIN_CONTRAST_US) {
+            return false;
+        }
+    }
+
+    uint16_t read_timeout = 0;
+
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        // The window can only shrink, the control frame budgets the default
+        uint16_t threshold = (sweep_min_us[i] + sweep_max_us[i]) / 2;
+        if (threshold > SENSOR_READ_TIMEOUT_US) {
+            threshold = SENSOR_READ_TIMEOUT_US;
+        }
+
+        calibration.min_us[i] = sweep_min_us[i];
+        calibration.max_us[i] = sweep_max_us[i];
+        calibration.threshold_us[i] = threshold;
+        if (threshold > read_timeout) read_timeout = threshold;
+    }
+
+    calibration.read_timeout_us = read_timeout;
+    calibration.valid = true;
+    sensors.read_window_us = read_timeout;
+
+    return true;
+}
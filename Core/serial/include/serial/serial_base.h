@@ -3,45 +3,57 @@
 
 #include <stdint.h>
 
-#define OPERATION_DATA_SIZE 8  // Size of the operation data message
+#define OPERATION_DATA_SIZE 8     // Size of the operation data message
+#define PROFILE_REPORT_SIZE 8     // Size of the profiler report messages
+#define SUPERVISOR_REPORT_SIZE 8  // Size of the supervisor report message
+#define RECOVERY_REPORT_SIZE 6    // Size of the line recovery report message
 
 /**
  * @brief Macro to define serial messages and their sizes.
  * @param X A macro that takes two parameters: the message name and its size in
  * bytes.
  */
-#define SERIAL_MESSAGES_TABLE(X) \
-    X(INVALID_MESSAGE, 0)        \
-    X(PING, 0)                   \
-    X(START, 0)                  \
-    X(STOP, 0)                   \
-    X(STATE, 1)                  \
-    X(RUNNING_MODE, 1)           \
-    X(STOP_MODE, 1)              \
-    X(LAPS, 1)                   \
-    X(STOP_TIME, 1)              \
-    X(STOP_DISTANCE, 2)          \
-    X(LOG_DATA, 1)               \
-    X(PID_KP, 1)                 \
-    X(PID_KI, 1)                 \
-    X(PID_KD, 2)                 \
-    X(PID_KB, 1)                 \
-    X(PID_KFF, 1)                \
-    X(PID_ALPHA, 2)              \
-    X(PID_CLAMP, 2)              \
-    X(PID_ACCEL, 2)              \
-    X(PID_BASE_PWM, 2)           \
-    X(PID_MAX_PWM, 2)            \
-    X(TURBINE_PWM, 2)            \
-    X(SPEED_KP, 2)               \
-    X(SPEED_KI, 2)               \
-    X(SPEED_KD, 2)               \
-    X(SPEED_KFF, 2)              \
-    X(BASE_SPEED, 2)             \
-    X(LOOKAHEAD, 1)              \
-    X(CURVATURE_GAIN, 2)         \
-    X(IMU_ALPHA, 2)              \
-    X(OPERATION_DATA, OPERATION_DATA_SIZE)
+#define SERIAL_MESSAGES_TABLE(X)              \
+    X(INVALID_MESSAGE, 0)                     \
+    X(PING, 0)                                \
+    X(START, 0)                               \
+    X(STOP, 0)                                \
+    X(STATE, 1)                               \
+    X(RUNNING_MODE, 1)                        \
+    X(STOP_MODE, 1)                           \
+    X(LAPS, 1)                                \
+    X(STOP_TIME, 1)                           \
+    X(STOP_DISTANCE, 2)                       \
+    X(LOG_DATA, 1)                            \
+    X(PID_KP, 1)                              \
+    X(PID_KI, 1)                              \
+    X(PID_KD, 2)                              \
+    X(PID_KB, 1)                              \
+    X(PID_KFF, 1)                             \
+    X(PID_ALPHA, 2)                           \
+    X(PID_CLAMP, 2)                           \
+    X(PID_ACCEL, 2)                           \
+    X(PID_BASE_PWM, 2)                        \
+    X(PID_MAX_PWM, 2)                         \
+    X(TURBINE_PWM, 2)                         \
+    X(SPEED_KP, 2)                            \
+    X(SPEED_KI, 2)                            \
+    X(SPEED_KD, 2)                            \
+    X(SPEED_KFF, 2)                           \
+    X(BASE_SPEED, 2)                          \
+    X(LOOKAHEAD, 1)                           \
+    X(CURVATURE_GAIN, 2)                      \
+    X(IMU_ALPHA, 2)                           \
+    X(OPERATION_DATA, OPERATION_DATA_SIZE)    \
+    X(PROFILE, 1)                             \
+    X(PROFILE_STATS, PROFILE_REPORT_SIZE)     \
+    X(PROFILE_HISTOGRAM, PROFILE_REPORT_SIZE) \
+    X(PID_FRAME, 2)                           \
+    X(SUPERVISOR, SUPERVISOR_REPORT_SIZE)     \
+    X(ERROR_MODE, 1)                          \
+    X(IR_WINDOW, 2)                           \
+    X(RECOVERY, RECOVERY_REPORT_SIZE)         \
+    X(SAVE_SETTINGS, 1)
 
 // Maximum payload size among all messages
 #define SERIAL_MESSAGE_MAX_PAYLOAD 8
@@ -3,6 +3,16 @@
 
 #include <stdbool.h>
 
+#include "serial/serial_base.h"
+
+/**
+ * @brief Applies a serial message as if it had just been received.
+ * @param msg The message to apply.
+ * @return true if the message is known, false otherwise.
+ * @note Nothing is acknowledged, so stored settings can be replayed at boot.
+ */
+bool apply_serial_message(const SerialMessage* const msg);
+
 /**
  * @brief Processes serial messages waiting in the USART receive buffer.
  * @return true if at least one message was processed, false otherwise.
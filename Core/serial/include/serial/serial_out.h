@@ -13,13 +13,13 @@
  * @brief Initializes the serial output module with references to the state
  * machine, PID controller, and track counters.
  * @param state_machine Pointer to the StateMachine struct.
- * @param sensor_state Pointer to the SensorState struct.
  * @param pid_struct Pointer to the PidStruct struct.
  * @param track_counters Pointer to the TrackCounters struct.
  * @param pure_pursuit_struct Pointer to the PurePursuit struct.
+ * @note Sensor readings are copied from the front frame when sent, see
+ * copy_sensor_frame().
  */
 void init_serial_out(const StateMachine* const state_machine,
-                     const SensorState* const sensor_state,
                      const PidStruct* const pid_struct,
                      const TrackCounters* const track_counters,
                      const PurePursuit* const pure_pursuit_struct);
@@ -2,12 +2,15 @@
 
 #include "hal/usart.h"
 #include "logger/logger.h"
+#include "pid/errors/errors.h"
 #include "pid/pid.h"
+#include "profiler/profiler.h"
 #include "pure_pursuit/pure_pursuit.h"
 #include "sensors/encoder.h"
 #include "serial/serial_base.h"
 #include "serial/serial_out.h"
 #include "state_machine/handlers/config_handler.h"
+#include "storage/settings.h"
 #include "track/track.h"
 #include "turbine/turbine.h"
 
@@ -49,10 +52,8 @@ static inline float parse_float(const uint8_t* const payload,
     return value;
 }
 
-static void handle_message(void) {
-    if (current_msg.message == INVALID_MESSAGE) return;
-
-    switch (current_msg.message) {
+bool apply_serial_message(const SerialMessage* const msg) {
+    switch (msg->message) {
         case PING:
             // No action needed for ping
             break;
@@ -63,87 +64,124 @@ static void handle_message(void) {
             set_can_run(false);
             break;
         case RUNNING_MODE:
-            set_running_mode((RunningModes)current_msg.payload[0]);
+            set_running_mode((RunningModes)msg->payload[0]);
             break;
         case STOP_MODE:
-            set_stop_mode((StopModes)current_msg.payload[0]);
+            set_stop_mode((StopModes)msg->payload[0]);
             break;
         case LAPS:
-            set_laps((uint8_t)current_msg.payload[0]);
+            set_laps((uint8_t)msg->payload[0]);
             break;
         case STOP_TIME:
-            set_stop_time((uint8_t)current_msg.payload[0]);
+            set_stop_time((uint8_t)msg->payload[0]);
             break;
         case LOG_DATA:
-            set_log_data((bool)current_msg.payload[0]);
+            set_log_data((bool)msg->payload[0]);
             break;
         case PID_KP:
-            set_pwm_kp((uint8_t)current_msg.payload[0]);
+            set_pwm_kp((uint8_t)msg->payload[0]);
             break;
         case PID_KI:
-            set_pwm_ki((uint8_t)current_msg.payload[0]);
+            set_pwm_ki((uint8_t)msg->payload[0]);
             break;
         case PID_KD:
-            set_pwm_kd(parse_uint16(current_msg.payload));
+            set_pwm_kd(parse_uint16(msg->payload));
             break;
         case PID_KB:
-            set_pwm_kb((uint8_t)current_msg.payload[0]);
+            set_pwm_kb((uint8_t)msg->payload[0]);
             break;
         case PID_KFF:
-            set_pwm_kff((uint8_t)current_msg.payload[0]);
+            set_pwm_kff((uint8_t)msg->payload[0]);
             break;
         case PID_ACCEL:
-            set_pwm_accel(parse_uint16(current_msg.payload));
+            set_pwm_accel(parse_uint16(msg->payload));
             break;
         case PID_BASE_PWM:
-            set_base_pwm(parse_uint16(current_msg.payload));
+            set_base_pwm(parse_uint16(msg->payload));
             break;
         case PID_MAX_PWM:
-            set_max_pwm(parse_uint16(current_msg.payload));
+            set_max_pwm(parse_uint16(msg->payload));
             break;
         case TURBINE_PWM:
-            set_turbine_pwm(parse_uint16(current_msg.payload));
+            set_turbine_pwm(parse_uint16(msg->payload));
             break;
         case SPEED_KP:
-            set_speed_kp(parse_uint16(current_msg.payload));
+            set_speed_kp(parse_uint16(msg->payload));
             break;
         case SPEED_KI:
-            set_speed_ki(parse_float(current_msg.payload, 4));
+            set_speed_ki(parse_float(msg->payload, 4));
             break;
         case SPEED_KD:
-            set_speed_kd(parse_uint16(current_msg.payload));
+            set_speed_kd(parse_uint16(msg->payload));
             break;
         case BASE_SPEED:
-            set_speed(parse_float(current_msg.payload, 2));
+            set_speed(parse_float(msg->payload, 2));
             break;
         case PID_ALPHA:
             // Convert from percentage to [0.0, 1.0] range
-            set_pwm_alpha(parse_float(current_msg.payload, 4));
+            set_pwm_alpha(parse_float(msg->payload, 4));
             break;
         case PID_CLAMP:
-            set_pwm_clamp(parse_uint16(current_msg.payload));
+            set_pwm_clamp(parse_uint16(msg->payload));
             break;
         case STOP_DISTANCE:
-            set_stop_distance(parse_uint16(current_msg.payload));
+            set_stop_distance(parse_uint16(msg->payload));
             break;
         case LOOKAHEAD:
-            set_lookahead((uint8_t)current_msg.payload[0]);
+            set_lookahead((uint8_t)msg->payload[0]);
             break;
         case SPEED_KFF:
-            set_speed_kff(parse_uint16(current_msg.payload));
+            set_speed_kff(parse_uint16(msg->payload));
             break;
         case CURVATURE_GAIN:
-            set_curvature_gain(parse_float(current_msg.payload, 2));
+            set_curvature_gain(parse_float(msg->payload, 2));
             break;
         case IMU_ALPHA:
             // Convert from percentage to [0.0, 1.0] range
-            set_imu_alpha(parse_float(current_msg.payload, 4));
+            set_imu_alpha(parse_float(msg->payload, 4));
+            break;
+        case PROFILE:
+            if (msg->payload[0]) reset_profiler();
+            break;
+        case PID_FRAME:
+            // The control timer keeps its period until the next run starts
+            if (get_state_machine()->current_state == STATE_RUNNING) {
+                debug_print("The PID frame can't change while running");
+                return false;
+            }
+            if (!set_pwm_frame_interval(parse_uint16(msg->payload))) {
+                debug_print("The PID frame is too short to run");
+                return false;
+            }
+            break;
+        case SUPERVISOR:
+            // Report only, acknowledged with the current statistics
+            break;
+        case ERROR_MODE:
+            set_error_mode((ErrorModes)msg->payload[0]);
+            break;
+        case IR_WINDOW:
+            // Report only, acknowledged with the current read window
+            break;
+        case RECOVERY:
+            // Report only, acknowledged with the line recovery statistics
+            break;
+        case SAVE_SETTINGS:
+            if (msg->payload[0]) save_settings();
             break;
         default:
             debug_print("Received unknown message");
-            return;
+            return false;
     }
 
+    remember_setting(msg);
+    return true;
+}
+
+static void handle_message(void) {
+    if (current_msg.message == INVALID_MESSAGE) return;
+    if (!apply_serial_message(&current_msg)) return;
+
     // Acknowledge by sending back the same message
     send_message(current_msg.message);
 }
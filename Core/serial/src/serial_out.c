@@ -3,11 +3,16 @@
 #include <stddef.h>
 
 #include "logger/logger.h"
+#include "profiler/profiler.h"
+#include "sensors/encoder.h"
+#include "sensors/sensors.h"
+#include "sensors/vision.h"
+#include "storage/settings.h"
+#include "supervisor/supervisor.h"
 #include "timer/time.h"
 #include "turbine/turbine.h"
 
 static const StateMachine* sm = NULL;
-static const SensorState* sensors = NULL;
 static const PidStruct* pid = NULL;
 static const TrackCounters* track = NULL;
 static const PurePursuit* pure_pursuit = NULL;
@@ -15,6 +20,9 @@ static const PurePursuit* pure_pursuit = NULL;
 static uint32_t last_log_time = 0;
 
 static uint8_t operation_data[OPERATION_DATA_SIZE] = {0};
+static uint8_t profile_report[PROFILE_REPORT_SIZE] = {0};
+static uint8_t supervisor_report[SUPERVISOR_REPORT_SIZE] = {0};
+static uint8_t recovery_report[RECOVERY_REPORT_SIZE] = {0};
 
 static inline uint16_t parse_float(float value, uint8_t precision) {
     for (; precision > 0; precision--) value *= 10.0f;
@@ -27,9 +35,12 @@ static inline int16_t parse_signed_float(float value, uint8_t precision) {
 }
 
 static inline void update_operation_data(void) {
-    operation_data[0] = sensors->ir_sensors->central_sensors_state;
-    operation_data[1] = sensors->ir_sensors->left_sensor;
-    operation_data[1] |= sensors->ir_sensors->right_sensor << 1;
+    SensorFrame frame;
+    copy_sensor_frame(&frame);
+
+    operation_data[0] = frame.ir_sensors.central_sensors_state;
+    operation_data[1] = frame.ir_sensors.left_sensor;
+    operation_data[1] |= frame.ir_sensors.right_sensor << 1;
 
     // Convert from cm to mm for higher precision
     const int16_t x = parse_signed_float(track->x, 1);
@@ -44,13 +55,81 @@ static inline void update_operation_data(void) {
     operation_data[7] = (heading >> 8);
 }
 
+static inline void put_uint16(uint8_t* const data, const uint32_t value) {
+    const uint16_t saturated = value > UINT16_MAX ? UINT16_MAX : value;
+    data[0] = saturated & 0xFF;
+    data[1] = (saturated >> 8);
+}
+
+static void send_profile_stats(const ProfileStages stage) {
+    const ProfileStats* const stats = get_profile_stats(stage);
+    const uint32_t mean_ns =
+        stats->count ? (uint32_t)(stats->total_ns / stats->count) : 0;
+
+    // Convert from ns to 0.1 us, saturating at 6553.5 us
+    profile_report[0] = stage;
+    put_uint16(&profile_report[1], stats->min_ns / 100);
+    put_uint16(&profile_report[3], mean_ns / 100);
+    put_uint16(&profile_report[5], stats->max_ns / 100);
+    profile_report[7] = 0;
+    send_data(PROFILE_STATS, profile_report);
+}
+
+static void send_profile_histogram(const ProfileStages stage) {
+    const ProfileStats* const stats = get_profile_stats(stage);
+
+    // Three bucket counts fit in each report after the stage and first bucket
+    for (uint8_t bucket = 0; bucket < PROFILE_BUCKETS; bucket += 3) {
+        profile_report[0] = stage;
+        profile_report[1] = bucket;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            const uint8_t index = bucket + i;
+            const uint32_t count =
+                index < PROFILE_BUCKETS ? stats->histogram[index] : 0;
+            put_uint16(&profile_report[2 + 2 * i], count);
+        }
+
+        send_data(PROFILE_HISTOGRAM, profile_report);
+    }
+}
+
+static void send_profile(void) {
+    const uint8_t stage_count = PROFILE_STAGE_COUNT;
+    send_data(PROFILE, &stage_count);
+
+    for (uint8_t stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        send_profile_stats((ProfileStages)stage);
+        send_profile_histogram((ProfileStages)stage);
+    }
+}
+
+static inline void update_supervisor_report(void) {
+    const Supervisor* const supervisor = get_supervisor();
+
+    supervisor_report[0] = supervisor->overruns & 0xFF;
+    supervisor_report[1] = (supervisor->overruns >> 8) & 0xFF;
+    supervisor_report[2] = (supervisor->overruns >> 16) & 0xFF;
+    supervisor_report[3] = (supervisor->overruns >> 24);
+    put_uint16(&supervisor_report[4], supervisor->max_lateness_us);
+    supervisor_report[6] = supervisor->longest_overrun_run;
+    supervisor_report[7] = supervisor->tripped;
+    supervisor_report[7] |= supervisor->watchdog_reset << 1;
+}
+
+static inline void update_recovery_report(void) {
+    const LineRecovery* const recovery = pid->recovery;
+
+    put_uint16(&recovery_report[0], recovery->count);
+    put_uint16(&recovery_report[2], recovery->last_time_ms);
+    put_uint16(&recovery_report[4], recovery->max_time_ms);
+}
+
 void init_serial_out(const StateMachine* const state_machine,
-                     const SensorState* const sensor_state,
                      const PidStruct* const pid_struct,
                      const TrackCounters* const track_counters,
                      const PurePursuit* const pure_pursuit_struct) {
     sm = state_machine;
-    sensors = sensor_state;
     pid = pid_struct;
     track = track_counters;
     pure_pursuit = pure_pursuit_struct;
@@ -58,6 +137,7 @@ void init_serial_out(const StateMachine* const state_machine,
 
 void send_message(const SerialMessages msg) {
     if (msg >= SERIAL_MESSAGE_COUNT) return;
+    if (!sm) return;  // Not initialized yet
 
     switch (msg) {
         case PING:
@@ -154,8 +234,9 @@ void send_message(const SerialMessages msg) {
             send_data(msg, (const uint8_t*)&pid->speed_pid->kff);
             break;
         case CURVATURE_GAIN:
+            // Settings are acknowledged live, before a frame publishes them
             const uint16_t gain =
-                parse_float(sensors->encoders->wheel_base_correction, 2);
+                parse_float(get_encoder_data()->wheel_base_correction, 2);
             send_data(msg, (const uint8_t*)&gain);
             break;
         case IMU_ALPHA:
@@ -163,6 +244,36 @@ void send_message(const SerialMessages msg) {
             const uint16_t imu_alpha = parse_float(track->imu_alpha, 4);
             send_data(msg, (const uint8_t*)&imu_alpha);
             break;
+        case PROFILE:
+            send_profile();
+            break;
+        case PROFILE_STATS:
+        case PROFILE_HISTOGRAM:
+            // Only sent as part of the PROFILE report
+            break;
+        case PID_FRAME:
+            const uint16_t frame_interval =
+                (uint16_t)pid->delta_pid->frame_interval;
+            send_data(msg, (const uint8_t*)&frame_interval);
+            break;
+        case SUPERVISOR:
+            update_supervisor_report();
+            send_data(msg, supervisor_report);
+            break;
+        case ERROR_MODE:
+            send_data(msg, (const uint8_t*)&pid->errors->mode);
+            break;
+        case IR_WINDOW:
+            send_data(msg, (const uint8_t*)&get_ir_sensors()->read_window_us);
+            break;
+        case RECOVERY:
+            update_recovery_report();
+            send_data(msg, recovery_report);
+            break;
+        case SAVE_SETTINGS:
+            const uint8_t saved = get_settings_saved();
+            send_data(msg, &saved);
+            break;
         default:
             debug_print("Attempted to send unknown message");
             break;
@@ -175,9 +286,12 @@ void send_messages(const SerialMessages* msgs, const uint8_t count) {
 }
 
 void send_all_messages(void) {
-    // Skip command signals and operation data
-    for (uint8_t i = STOP + 1; i < SERIAL_MESSAGE_COUNT; i++) {
-        if (i == OPERATION_DATA) continue;
+    // Skip command signals, operation data and the profiler reports
+    for (uint8_t i = STOP + 1; i < OPERATION_DATA; i++) {
+        send_message((SerialMessages)i);
+    }
+
+    for (uint8_t i = PROFILE_HISTOGRAM + 1; i < SERIAL_MESSAGE_COUNT; i++) {
         send_message((SerialMessages)i);
     }
 }
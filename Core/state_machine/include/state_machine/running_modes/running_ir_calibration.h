@@ -0,0 +1,20 @@
+#ifndef RUNNING_IR_CALIBRATION_H
+#define RUNNING_IR_CALIBRATION_H
+
+#include "../state_machine_base.h"
+
+/**
+ * @brief Handles the running IR calibration mode logic.
+ * @param sm Pointer to the state machine structure.
+ * @note The robot must be placed over the line, it then turns in place from
+ * side to side, recording the discharge extremes of each central sensor.
+ */
+void running_ir_calibration(const StateMachine* const sm);
+
+/**
+ * @brief Handles the transition from running IR calibration mode to stopped
+ * state.
+ */
+void running_ir_calibration_to_stopped(void);
+
+#endif  // RUNNING_IR_CALIBRATION_H
@@ -20,7 +20,7 @@ void running_encoder_test(const StateMachine* const sm) {
 
         debug_print_encoder_speeds();
 
-        if (pid->errors->sensors->encoders->distance >=
+        if (pid->errors->sensors->frame->encoders.distance >=
             ENCODER_TEST_DISTANCE_CM) {
             debug_print("Reached target distance for encoder test");
             break;
@@ -0,0 +1,53 @@
+#include "state_machine/running_modes/running_ir_calibration.h"
+
+#include "logger/logger.h"
+#include "motors/motors.h"
+#include "sensors/vision.h"
+#include "serial/serial_in.h"
+#include "timer/time.h"
+
+#define CALIBRATION_PWM 150       // PWM used to turn in place
+#define CALIBRATION_SWEEP_MS 300  // Time to turn from one side to the other
+#define CALIBRATION_SWEEPS 4      // Full sweeps across the line
+
+static inline void turn(const int16_t pwm) { set_motors(-pwm, pwm); }
+
+void running_ir_calibration(const StateMachine* const sm) {
+    debug_print("RUNNING_IR_CALIBRATION Mode: Handling running logic");
+
+    start_ir_calibration();
+
+    // Half sweeps at both ends keep the robot centered on the line
+    uint8_t sweep = 0;
+    uint32_t sweep_time = CALIBRATION_SWEEP_MS / 2;
+    uint32_t sweep_start = time();
+    int16_t pwm = CALIBRATION_PWM;
+    turn(pwm);
+
+    while (sm->can_run && sweep <= CALIBRATION_SWEEPS) {
+        update_ir_calibration();
+        process_serial_messages();
+
+        if (!time_elapsed(sweep_start, sweep_time)) continue;
+
+        sweep++;
+        sweep_time = sweep < CALIBRATION_SWEEPS ? CALIBRATION_SWEEP_MS
+                                                : CALIBRATION_SWEEP_MS / 2;
+        sweep_start = time();
+        pwm = -pwm;
+        turn(pwm);
+    }
+
+    set_motors(0, 0);
+
+    if (finish_ir_calibration()) {
+        debug_print("IR calibration stored");
+    } else {
+        debug_print("IR calibration failed, keeping the previous one");
+    }
+
+    debug_print_ir_calibration();
+    debug_print("Finalizing RUNNING_IR_CALIBRATION mode");
+}
+
+void running_ir_calibration_to_stopped(void) { set_motors(0, 0); }
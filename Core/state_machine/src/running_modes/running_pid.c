@@ -1,35 +1,97 @@
 #include "state_machine/running_modes/running_pid.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "logger/logger.h"
 #include "pid/pid.h"
-#include "sensors/encoder.h"
+#include "profiler/profiler.h"
+#include "scheduler/scheduler.h"
+#include "sensors/sensors.h"
 #include "serial/serial_in.h"
 #include "serial/serial_out.h"
 #include "state_machine/handlers/config_handler.h"
 #include "state_machine/running_modes/running_base.h"
+#include "supervisor/supervisor.h"
 #include "track/track.h"
 
+#define TRACK_PERIOD_US 1000      // Track bookkeeping, as the delta PID frame
+#define ODOMETRY_PERIOD_US 10000  // Encoder update, as the speed PID frame
+#define SERIAL_PHASE_US 500       // Serial work runs in the frame slack
+
+typedef enum {
+    ODOMETRY_TASK_PRIORITY,
+    TRACK_TASK_PRIORITY,
+    TELEMETRY_TASK_PRIORITY,
+    SERIAL_TASK_PRIORITY,
+} PidTaskPriorities;
+
+static const StateMachine* state_machine = NULL;
+static bool odometry_updated = false;
+
+static bool run_odometry_task(void) {
+    update_encoder_sensors();
+    odometry_updated = true;
+    return true;
+}
+
+static bool run_track_task(void) {
+    profile_start(PROFILE_TRACK);
+    const bool track_updated = update_track(odometry_updated);
+    profile_end(PROFILE_TRACK);
+
+    odometry_updated = false;
+    check_stop(track_updated);
+    return true;
+}
+
+static bool run_telemetry_task(void) {
+    if (state_machine->log_data) send_message(OPERATION_DATA);
+    return true;
+}
+
+static bool run_serial_task(void) {
+    profile_start(PROFILE_SERIAL);
+    process_serial_messages();
+    profile_end(PROFILE_SERIAL);
+    return true;
+}
+
+static const SchedulerTask PID_TASKS[] = {
+    {"odometry", run_odometry_task, ODOMETRY_PERIOD_US, 0,
+     ODOMETRY_TASK_PRIORITY},
+    {"track", run_track_task, TRACK_PERIOD_US, 0, TRACK_TASK_PRIORITY},
+    {"telemetry", run_telemetry_task, TRACK_PERIOD_US, SERIAL_PHASE_US,
+     TELEMETRY_TASK_PRIORITY},
+    {"serial", run_serial_task, TRACK_PERIOD_US, SERIAL_PHASE_US,
+     SERIAL_TASK_PRIORITY},
+};
+
+#define PID_TASK_COUNT (sizeof(PID_TASKS) / sizeof(PID_TASKS[0]))
+
 void running_pid(const StateMachine* const sm) {
     debug_print("RUNNING_PID Mode: Handling running logic");
 
-    const PidStruct* pid = get_pid();
+    state_machine = sm;
+    odometry_updated = false;
 
     start_turbine_if_needed();
     set_start_time();
 
+    // The delta PID runs from the control timer, the rest stays in foreground
+    start_supervisor(get_pid()->delta_pid->frame_interval);
+    start_pid_timer();
+    init_scheduler(PID_TASKS, PID_TASK_COUNT);
     while (sm->can_run) {
-        if (!update_pid()) continue;
-
-        check_stop(update_track(
-            update_encoder_data_async(pid->speed_pid->frame_interval)));
-
-        if (sm->log_data) send_message(OPERATION_DATA);
-        process_serial_messages();
+        run_scheduler();
+        supervise_foreground();
     }
+    stop_pid_timer();
+    stop_supervisor();
 
+    debug_print_scheduler();
+    debug_print_supervisor();
     debug_print("Finalizing RUNNING_PID mode");
 }
 
@@ -1,31 +1,101 @@
 #include "state_machine/running_modes/running_pure_pursuit.h"
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "logger/logger.h"
 #include "pid/pid.h"
+#include "profiler/profiler.h"
 #include "pure_pursuit/pure_pursuit.h"
+#include "scheduler/scheduler.h"
 #include "serial/serial_in.h"
 #include "serial/serial_out.h"
 #include "state_machine/handlers/config_handler.h"
 #include "state_machine/running_modes/running_base.h"
+#include "supervisor/supervisor.h"
 #include "track/track.h"
 
+#define SENSORS_PERIOD_US 1000        // Sensor read and track update (1 kHz)
+#define PURE_PURSUIT_PERIOD_US 10000  // Pure Pursuit and speed PID (100 Hz)
+#define SERIAL_PHASE_US 500           // Serial work runs in the frame slack
+
+typedef enum {
+    SENSORS_TASK_PRIORITY,
+    TRACK_TASK_PRIORITY,
+    PURE_PURSUIT_TASK_PRIORITY,
+    TELEMETRY_TASK_PRIORITY,
+    SERIAL_TASK_PRIORITY,
+} PurePursuitTaskPriorities;
+
+static const StateMachine* state_machine = NULL;
+
+static bool run_sensors_task(void) {
+    if (!update_peripheral_sensors_frame()) return false;
+
+    supervise_tick();
+    profile_end(PROFILE_PERIOD);
+    profile_start(PROFILE_PERIOD);
+    return true;
+}
+
+static bool run_track_task(void) {
+    profile_start(PROFILE_TRACK);
+    const bool track_updated = update_track(false);
+    profile_end(PROFILE_TRACK);
+
+    check_stop(track_updated);
+    return true;
+}
+
+static bool run_pure_pursuit_task(void) {
+    update_pure_pursuit_frame();
+    return true;
+}
+
+static bool run_telemetry_task(void) {
+    if (state_machine->log_data) send_message(OPERATION_DATA);
+    return true;
+}
+
+static bool run_serial_task(void) {
+    profile_start(PROFILE_SERIAL);
+    process_serial_messages();
+    profile_end(PROFILE_SERIAL);
+    return true;
+}
+
+static const SchedulerTask PURE_PURSUIT_TASKS[] = {
+    {"sensors", run_sensors_task, SENSORS_PERIOD_US, 0, SENSORS_TASK_PRIORITY},
+    {"track", run_track_task, SENSORS_PERIOD_US, 0, TRACK_TASK_PRIORITY},
+    {"pure_pursuit", run_pure_pursuit_task, PURE_PURSUIT_PERIOD_US, 0,
+     PURE_PURSUIT_TASK_PRIORITY},
+    {"telemetry", run_telemetry_task, PURE_PURSUIT_PERIOD_US, SERIAL_PHASE_US,
+     TELEMETRY_TASK_PRIORITY},
+    {"serial", run_serial_task, SENSORS_PERIOD_US, SERIAL_PHASE_US,
+     SERIAL_TASK_PRIORITY},
+};
+
+#define PURE_PURSUIT_TASK_COUNT \
+    (sizeof(PURE_PURSUIT_TASKS) / sizeof(PURE_PURSUIT_TASKS[0]))
+
 void running_pure_pursuit(const StateMachine* const sm) {
     debug_print("RUNNING_PURE_PURSUIT Mode: Handling running logic");
 
+    state_machine = sm;
+
     start_turbine_if_needed();
     set_start_time();
 
+    start_supervisor(SENSORS_PERIOD_US);
+    init_scheduler(PURE_PURSUIT_TASKS, PURE_PURSUIT_TASK_COUNT);
     while (sm->can_run) {
-        if (!update_peripheral_sensors()) continue;
-
-        check_stop(update_track(false));
-        process_serial_messages();
-
-        if (!update_pure_pursuit()) continue;
-
-        if (sm->log_data) send_message(OPERATION_DATA);
+        run_scheduler();
+        supervise_foreground();
     }
+    stop_supervisor();
 
+    debug_print_scheduler();
+    debug_print_supervisor();
     debug_print("Finalizing RUNNING_PURE_PURSUIT mode");
 }
 
@@ -1,6 +1,7 @@
 #include "state_machine/states/idle.h"
 
 #include "logger/logger.h"
+#include "sensors/sensors.h"
 #include "serial/serial_in.h"
 #include "serial/serial_out.h"
 #include "state_machine/handlers/state_handler.h"
@@ -9,6 +10,7 @@ void handle_idle(const StateMachine* const sm) {
     debug_print("IDLE State: Waiting for bluetooth commands");
 
     while (!sm->can_run) {
+        update_idle_sensors();
         send_all_messages_async(LOG_INTERVAL);
         process_serial_messages();
     }
@@ -3,12 +3,15 @@
 #include "logger/logger.h"
 #include "motors/motors.h"
 #include "pid/pid.h"
+#include "profiler/profiler.h"
 #include "pure_pursuit/pure_pursuit.h"
 #include "sensors/sensors.h"
 #include "serial/serial_base.h"
 #include "serial/serial_out.h"
 #include "state_machine/handlers/state_handler.h"
 #include "state_machine/running_modes/running_base.h"
+#include "storage/settings.h"
+#include "supervisor/supervisor.h"
 #include "timer/time.h"
 #include "track/track.h"
 
@@ -17,6 +20,12 @@ void handle_init(const StateMachine* const sm) {
 
     init_serial();
     init_timer();
+    init_profiler();
+
+    if (init_supervisor()->watchdog_reset) {
+        debug_print("Recovered from a watchdog reset");
+    }
+
     init_motors();
 
     const SensorState* const sensors = init_sensors();
@@ -25,7 +34,10 @@ void handle_init(const StateMachine* const sm) {
     const PurePursuit* const pp = init_pure_pursuit(track_counters, pid);
 
     init_running_modes(track_counters);
-    init_serial_out(sm, sensors, pid, track_counters, pp);
+    init_serial_out(sm, pid, track_counters, pp);
+
+    // Saved tuning and calibrations replace the defaults set above
+    init_settings();
 
     request_next_state(STATE_IDLE);
 }
@@ -2,6 +2,7 @@
 
 #include "logger/logger.h"
 #include "pid/pid.h"
+#include "profiler/profiler.h"
 #include "pure_pursuit/pure_pursuit.h"
 #include "sensors/mpu.h"
 #include "sensors/sensors.h"
@@ -12,6 +13,7 @@
 
 // Running modes
 #include "state_machine/running_modes/running_encoder_test.h"
+#include "state_machine/running_modes/running_ir_calibration.h"
 #include "state_machine/running_modes/running_pid.h"
 #include "state_machine/running_modes/running_pure_pursuit.h"
 #include "state_machine/running_modes/running_sensor_test.h"
@@ -23,7 +25,9 @@ void handle_running(const StateMachine* const sm) {
     reset_track();
     restart_pid();
     restart_pure_pursuit();
+    reset_profiler();
 
+    // The bias converges while idle, this only blocks if idle was too short
     mpu_calibrate_gyro();
 
     switch (sm->running_mode) {
@@ -56,6 +60,10 @@ void handle_running(const StateMachine* const sm) {
             debug_print("Running mode set to RUNNING_PURE_PURSUIT");
             running_pure_pursuit(sm);
             break;
+        case RUNNING_IR_CALIBRATION:
+            debug_print("Running mode set to RUNNING_IR_CALIBRATION");
+            running_ir_calibration(sm);
+            break;
         default:
             debug_print("Unknown running mode set, going back to IDLE state");
             request_next_state(STATE_IDLE);
@@ -91,6 +99,9 @@ static bool handle_running_to_stopped(const RunningModes running_mode) {
         case RUNNING_PURE_PURSUIT:
             running_pure_pursuit_to_stopped();
             break;
+        case RUNNING_IR_CALIBRATION:
+            running_ir_calibration_to_stopped();
+            break;
         default:
             debug_print("Unknown running mode, going to error state");
             return false;
@@ -0,0 +1,38 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdbool.h>
+
+#include "serial/serial_base.h"
+
+/**
+ * @brief Restores the last saved settings and calibrations from flash.
+ * @note Settings are replayed through the serial handlers, so every module
+ * they reach must be initialized first.
+ */
+void init_settings(void);
+
+/**
+ * @brief Keeps the payload of a received setting for the next save.
+ * @param msg The received message, ignored unless it is a stored setting.
+ */
+void remember_setting(const SerialMessage* const msg);
+
+/**
+ * @brief Saves the settings received over serial, the gyroscope bias and the
+ * IR calibration to flash.
+ * @return true if everything was saved, false otherwise.
+ * @note Only saves while idle, since flash writes stall the CPU. When the
+ * store is full its latest values are first compacted into the spare sector,
+ * which blocks for up to two FLASH_ERASE_TIMEOUT_MS erases.
+ */
+bool save_settings(void);
+
+/**
+ * @brief Returns the outcome of the last save.
+ * @return true if the last save stored everything, false if it failed or no
+ * save was requested yet.
+ */
+bool get_settings_saved(void);
+
+#endif  // SETTINGS_H
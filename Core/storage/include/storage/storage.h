@@ -0,0 +1,74 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STORAGE_KEY_COUNT 128  // Keys go from 0 to STORAGE_KEY_COUNT - 1
+#define STORAGE_MAX_SIZE 64    // Largest value in bytes
+
+/**
+ * @brief Flash bytes taken by a record holding a value of the given size.
+ * @note Each record has a header word with its key, size and CRC, and the
+ * value padded to whole words.
+ */
+#define STORAGE_RECORD_SIZE(size) (4U + (((uint32_t)(size) + 3U) & ~3U))
+
+/**
+ * @brief Scans the flash store, indexing the latest valid record of each key.
+ * @return true if the store is usable, false if the firmware image reaches
+ * into its sectors.
+ * @note The store alternates between two sectors, and the one with the latest
+ * sector header holds the records. Records with a wrong CRC, as left by a
+ * power loss while writing, are skipped, so their key keeps its previous
+ * value.
+ */
+bool init_storage(void);
+
+/**
+ * @brief Reads the latest value stored for a key.
+ * @param key The key to read.
+ * @param data Buffer the value is copied to.
+ * @param size Expected size of the value in bytes.
+ * @return true if a value of that size was found, false otherwise.
+ */
+bool read_storage(const uint8_t key, void* const data, const uint8_t size);
+
+/**
+ * @brief Appends a new value for a key to the flash store.
+ * @param key The key to write.
+ * @param data Value to store.
+ * @param size Size of the value in bytes, up to STORAGE_MAX_SIZE.
+ * @return true if the value was stored, false if it did not fit or the write
+ * failed.
+ * @note Values equal to the stored ones are not written again.
+ */
+bool write_storage(const uint8_t key, const void* const data,
+                   const uint8_t size);
+
+/**
+ * @brief Returns the flash bytes still free for new records.
+ * @return Free bytes in the store.
+ */
+uint32_t get_storage_free(void);
+
+/**
+ * @brief Erases the spare sector of the flash store, unless already blank.
+ * @return true if the spare sector is blank, false otherwise.
+ * @note Blocks for up to FLASH_ERASE_TIMEOUT_MS. Needed before
+ * compact_storage().
+ */
+bool erase_storage_spare(void);
+
+/**
+ * @brief Copies the latest record of every key into the spare sector, which
+ * then holds the records, and erases the old sector.
+ * @return true if the records were moved, false if the spare sector was not
+ * blank or a write failed.
+ * @note Blocks for up to FLASH_ERASE_TIMEOUT_MS. A power loss before the new
+ * sector header is written leaves the old sector in use, and one after it
+ * leaves the old sector to be erased by the next erase_storage_spare().
+ */
+bool compact_storage(void);
+
+#endif  // STORAGE_H
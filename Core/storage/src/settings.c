@@ -0,0 +1,170 @@
+#include "storage/settings.h"
+
+#include <stddef.h>
+
+#include "hal/flash.h"
+#include "logger/logger.h"
+#include "sensors/mpu.h"
+#include "sensors/vision.h"
+#include "serial/serial_in.h"
+#include "state_machine/handlers/config_handler.h"
+#include "storage/storage.h"
+#include "supervisor/supervisor.h"
+
+// Settings are keyed by their message, calibrations come after every message
+#define GYRO_BIAS_KEY 0x40
+#define IR_CALIBRATION_KEY 0x41
+
+_Static_assert(SERIAL_MESSAGE_COUNT <= GYRO_BIAS_KEY,
+               "Setting keys must not overlap the calibration keys");
+_Static_assert(sizeof(IrCalibration) <= STORAGE_MAX_SIZE,
+               "The IR calibration must fit in a single record");
+
+static const SerialMessages STORED_SETTINGS[] = {
+    RUNNING_MODE, STOP_MODE, LAPS, STOP_TIME, STOP_DISTANCE, LOG_DATA,
+    PID_KP, PID_KI, PID_KD, PID_KB, PID_KFF, PID_ALPHA, PID_CLAMP, PID_ACCEL,
+    PID_BASE_PWM, PID_MAX_PWM, TURBINE_PWM, SPEED_KP, SPEED_KI, SPEED_KD,
+    SPEED_KFF, BASE_SPEED, LOOKAHEAD, CURVATURE_GAIN, IMU_ALPHA, PID_FRAME,
+    ERROR_MODE,
+};
+
+#define STORED_SETTINGS_COUNT \
+    (sizeof(STORED_SETTINGS) / sizeof(STORED_SETTINGS[0]))
+
+static SerialMessage settings[SERIAL_MESSAGE_COUNT] = {0};
+static bool settings_saved = false;
+
+static bool is_stored_setting(const SerialMessages message) {
+    for (uint8_t i = 0; i < STORED_SETTINGS_COUNT; i++) {
+        if (STORED_SETTINGS[i] == message) return true;
+    }
+
+    return false;
+}
+
+static uint8_t restore_stored_settings(void) {
+    uint8_t restored = 0;
+
+    for (uint8_t i = 0; i < STORED_SETTINGS_COUNT; i++) {
+        const SerialMessages message = STORED_SETTINGS[i];
+        uint8_t payload[SERIAL_MESSAGE_MAX_PAYLOAD];
+        if (!read_storage(message, payload, SERIAL_MESSAGE_SIZES[message])) {
+            continue;
+        }
+
+        const SerialMessage msg = serial_message(message, payload);
+        if (apply_serial_message(&msg)) restored++;
+    }
+
+    return restored;
+}
+
+static void restore_calibrations(void) {
+    GyroBias bias;
+    if (read_storage(GYRO_BIAS_KEY, &bias, sizeof(bias))) {
+        set_mpu_gyro_bias(&bias);
+        debug_print("Restored the MPU gyroscope biases");
+    }
+
+    IrCalibration calibration;
+    if (read_storage(IR_CALIBRATION_KEY, &calibration, sizeof(calibration)) &&
+        set_ir_calibration(&calibration)) {
+        debug_print("Restored the IR sensor calibration");
+    }
+}
+
+static uint32_t get_save_size(const bool save_bias, const bool save_ir) {
+    uint32_t size = 0;
+
+    for (uint8_t i = 0; i < STORED_SETTINGS_COUNT; i++) {
+        const SerialMessages message = STORED_SETTINGS[i];
+        if (settings[message].message == INVALID_MESSAGE) continue;
+        size += STORAGE_RECORD_SIZE(settings[message].size);
+    }
+
+    if (save_bias) size += STORAGE_RECORD_SIZE(sizeof(GyroBias));
+    if (save_ir) size += STORAGE_RECORD_SIZE(sizeof(IrCalibration));
+    return size;
+}
+
+static bool make_room(const uint32_t size) {
+    if (get_storage_free() >= size) return true;
+
+    // Every fetch stalls during an erase, SysTick refreshes included, and
+    // there can be one before and one after the compaction
+    extend_watchdog(FLASH_ERASE_TIMEOUT_MS);
+    bool compacted = erase_storage_spare();
+    extend_watchdog(FLASH_ERASE_TIMEOUT_MS);
+    compacted = compacted && compact_storage();
+    restore_watchdog();
+
+    return compacted && get_storage_free() >= size;
+}
+
+static bool write_settings(const bool save_bias, const bool save_ir) {
+    bool written = true;
+
+    for (uint8_t i = 0; i < STORED_SETTINGS_COUNT; i++) {
+        const SerialMessage* const msg = &settings[STORED_SETTINGS[i]];
+        if (msg->message == INVALID_MESSAGE) continue;
+        written &= write_storage(msg->message, msg->payload, msg->size);
+    }
+
+    if (save_bias) {
+        const GyroBias bias = get_mpu_gyro_bias();
+        written &= write_storage(GYRO_BIAS_KEY, &bias, sizeof(bias));
+    }
+
+    if (save_ir) {
+        written &= write_storage(IR_CALIBRATION_KEY, get_ir_calibration(),
+                                 sizeof(IrCalibration));
+    }
+
+    return written;
+}
+
+void init_settings(void) {
+    if (!init_storage()) {
+        debug_print("The firmware reaches into the settings flash sectors");
+        return;
+    }
+
+    // A calibrated read window may allow a shorter PID frame than the default
+    restore_calibrations();
+    const uint8_t restored = restore_stored_settings();
+
+    debug_print(restored ? "Restored the saved settings"
+                         : "No saved settings found");
+}
+
+void remember_setting(const SerialMessage* const msg) {
+    if (!is_stored_setting(msg->message)) return;
+    settings[msg->message] = *msg;
+}
+
+bool save_settings(void) {
+    settings_saved = false;
+
+    // Flash writes stall the CPU, so a run would lose its control frames
+    if (get_state_machine()->current_state != STATE_IDLE) {
+        debug_print("Settings can only be saved while idle");
+        return false;
+    }
+
+    // Estimates that never converged would overwrite good stored ones
+    const bool save_bias = mpu_gyro_bias_converged();
+    const bool save_ir = get_ir_calibration()->valid;
+
+    // A full store is compacted first, keeping the values not set this boot
+    if (!make_room(get_save_size(save_bias, save_ir)) ||
+        !write_settings(save_bias, save_ir)) {
+        debug_print("Failed to save the settings");
+        return false;
+    }
+
+    settings_saved = true;
+    debug_print("Settings saved");
+    return true;
+}
+
+bool get_settings_saved(void) { return settings_saved; }
@@ -0,0 +1,227 @@
+#include "storage/storage.h"
+
+#include <string.h>
+
+#include "hal/flash.h"
+
+#define RECORD_WORDS(size) (STORAGE_RECORD_SIZE(size) / 4U)
+#define NO_RECORD UINT16_MAX  // Sector words always fit below it
+#define FIRST_RECORD 1U       // Records follow the sector header
+
+#define CRC_INITIAL 0xFFFF
+#define CRC_POLYNOMIAL 0x1021  // CRC-16/CCITT
+
+// Header word layout, erased headers mark the end of the log
+#define HEADER_KEY(header) ((uint8_t)((header) & 0xFF))
+#define HEADER_SIZE(header) ((uint8_t)(((header) >> 8) & 0xFF))
+#define HEADER_CRC(header) ((uint16_t)((header) >> 16))
+
+// Sector header layout, the sequence and its complement. The sector with the
+// latest sequence holds the records, erased or cut headers hold none.
+#define SECTOR_HEADER(sequence) \
+    ((uint32_t)(sequence) | ((uint32_t)(uint16_t)~(sequence) << 16))
+#define SECTOR_SEQUENCE(header) ((uint16_t)((header) & 0xFFFF))
+#define IS_SECTOR_HEADER(header) \
+    (SECTOR_HEADER(SECTOR_SEQUENCE(header)) == (header))
+
+static bool store_available = false;
+static uint8_t active_sector = 0;
+static uint16_t active_sequence = 0;
+static uint16_t records[STORAGE_KEY_COUNT] = {0};
+static uint32_t end_offset = 0;
+
+static uint16_t update_crc(uint16_t crc, const uint8_t* const data,
+                           const uint8_t size) {
+    for (uint8_t i = 0; i < size; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ CRC_POLYNOMIAL)
+                                 : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static uint16_t get_record_crc(const uint8_t key, const uint8_t size,
+                               const uint8_t* const data) {
+    const uint8_t header[2] = {key, size};
+    return update_crc(update_crc(CRC_INITIAL, header, sizeof(header)), data,
+                      size);
+}
+
+static inline const uint32_t* get_active_store(void) {
+    return get_flash_store(active_sector);
+}
+
+static inline uint8_t get_spare_sector(void) {
+    return (uint8_t)((active_sector + 1U) % FLASH_STORE_SECTORS);
+}
+
+static inline const uint8_t* get_record_data(const uint16_t offset) {
+    return (const uint8_t*)&get_active_store()[offset + 1];
+}
+
+// Until a sector is found the store counts as full, so the first save
+// compacts into a fresh one
+static void clear_records(void) {
+    for (uint8_t key = 0; key < STORAGE_KEY_COUNT; key++) {
+        records[key] = NO_RECORD;
+    }
+    end_offset = FLASH_STORE_WORDS;
+}
+
+static bool find_active_sector(void) {
+    bool found = false;
+
+    for (uint8_t sector = 0; sector < FLASH_STORE_SECTORS; sector++) {
+        const uint32_t header = get_flash_store(sector)[0];
+        if (!IS_SECTOR_HEADER(header)) continue;
+
+        // Sequences wrap, so the latest is less than half a turn ahead
+        const uint16_t sequence = SECTOR_SEQUENCE(header);
+        if (!found || (int16_t)(sequence - active_sequence) > 0) {
+            active_sector = sector;
+            active_sequence = sequence;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+static void index_records(void) {
+    const uint32_t* const store = get_active_store();
+    clear_records();
+    end_offset = FIRST_RECORD;
+
+    while (end_offset < FLASH_STORE_WORDS) {
+        const uint32_t header = store[end_offset];
+        if (header == FLASH_ERASED_WORD) break;
+
+        const uint8_t key = HEADER_KEY(header);
+        const uint8_t size = HEADER_SIZE(header);
+        const uint32_t words = RECORD_WORDS(size);
+
+        // A corrupted size can't be skipped, so nothing more fits after it
+        if (size > STORAGE_MAX_SIZE || end_offset + words > FLASH_STORE_WORDS) {
+            end_offset = FLASH_STORE_WORDS;
+            break;
+        }
+
+        const uint16_t offset = (uint16_t)end_offset;
+        if (key < STORAGE_KEY_COUNT &&
+            HEADER_CRC(header) ==
+                get_record_crc(key, size, get_record_data(offset))) {
+            records[key] = offset;
+        }
+
+        end_offset += words;
+    }
+}
+
+static bool is_sector_blank(const uint8_t sector) {
+    const uint32_t* const store = get_flash_store(sector);
+
+    for (uint32_t i = 0; i < FLASH_STORE_WORDS; i++) {
+        if (store[i] != FLASH_ERASED_WORD) return false;
+    }
+
+    return true;
+}
+
+bool init_storage(void) {
+    clear_records();
+    active_sector = 0;
+    active_sequence = 0;
+
+    store_available = check_flash_store();
+    if (store_available && find_active_sector()) index_records();
+
+    return store_available;
+}
+
+bool read_storage(const uint8_t key, void* const data, const uint8_t size) {
+    if (key >= STORAGE_KEY_COUNT || records[key] == NO_RECORD) return false;
+
+    const uint16_t offset = records[key];
+    if (HEADER_SIZE(get_active_store()[offset]) != size) return false;
+
+    memcpy(data, get_record_data(offset), size);
+    return true;
+}
+
+bool write_storage(const uint8_t key, const void* const data,
+                   const uint8_t size) {
+    if (key >= STORAGE_KEY_COUNT || size > STORAGE_MAX_SIZE) return false;
+
+    // Skipping unchanged values saves sector erases
+    if (records[key] != NO_RECORD &&
+        HEADER_SIZE(get_active_store()[records[key]]) == size &&
+        memcmp(get_record_data(records[key]), data, size) == 0) {
+        return true;
+    }
+
+    const uint32_t words = RECORD_WORDS(size);
+    if (end_offset + words > FLASH_STORE_WORDS) return false;
+
+    // Padding stays erased, the header goes first so a cut write is skipped
+    uint32_t record[RECORD_WORDS(STORAGE_MAX_SIZE)];
+    memset(record, 0xFF, sizeof(record));
+    memcpy(&record[1], data, size);
+    record[0] = (uint32_t)key | ((uint32_t)size << 8) |
+                ((uint32_t)get_record_crc(key, size, (const uint8_t*)data)
+                 << 16);
+
+    const uint16_t offset = (uint16_t)end_offset;
+    end_offset += words;
+    if (!program_flash_store(active_sector, offset, record, (uint16_t)words)) {
+        return false;
+    }
+
+    records[key] = offset;
+    return true;
+}
+
+uint32_t get_storage_free(void) {
+    return (FLASH_STORE_WORDS - end_offset) * 4U;
+}
+
+bool erase_storage_spare(void) {
+    if (!store_available) return false;
+
+    // Left set by a cut compaction or a failed erase
+    const uint8_t spare = get_spare_sector();
+    return is_sector_blank(spare) || erase_flash_store(spare);
+}
+
+bool compact_storage(void) {
+    const uint8_t spare = get_spare_sector();
+    if (!store_available || !is_sector_blank(spare)) return false;
+
+    // The latest record of every key moves, set this boot or not
+    const uint32_t* const store = get_active_store();
+    uint32_t offset = FIRST_RECORD;
+    for (uint8_t key = 0; key < STORAGE_KEY_COUNT; key++) {
+        if (records[key] == NO_RECORD) continue;
+
+        const uint32_t* const record = &store[records[key]];
+        const uint16_t words = (uint16_t)RECORD_WORDS(HEADER_SIZE(record[0]));
+        if (!program_flash_store(spare, offset, record, words)) return false;
+        offset += words;
+    }
+
+    // The header goes last, so a cut compaction leaves the old sector in use
+    const uint16_t sequence = (uint16_t)(active_sequence + 1U);
+    const uint32_t header = SECTOR_HEADER(sequence);
+    if (!program_flash_store(spare, 0, &header, 1)) return false;
+
+    const uint8_t old_sector = active_sector;
+    active_sector = spare;
+    active_sequence = sequence;
+    index_records();
+
+    // A failed erase is only retried by the next compaction
+    erase_flash_store(old_sector);
+    return true;
+}
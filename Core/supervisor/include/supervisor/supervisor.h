@@ -0,0 +1,70 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdint.h>
+
+#include "supervisor/supervisor_base.h"
+
+/**
+ * @brief Initializes the supervisor and starts the hardware watchdog.
+ * @return Pointer to the Supervisor structure.
+ * @note Outside supervised runs the watchdog is kept alive by SysTick, so
+ * blocking work with the motors stopped doesn't reset the MCU.
+ */
+const Supervisor* init_supervisor(void);
+
+/**
+ * @brief Returns a pointer to the Supervisor structure.
+ * @return Pointer to the Supervisor containing the deadline statistics.
+ */
+const Supervisor* get_supervisor(void);
+
+/**
+ * @brief Starts supervising the control ticks of a running mode.
+ * @param period_us The control tick period in microseconds. Each tick must
+ * finish within one period from the start of its frame.
+ * @note Clears the statistics of the previous run. From this call on the
+ * watchdog is only fed by healthy ticks, so it should be made right before
+ * the control loop starts.
+ */
+void start_supervisor(const uint32_t period_us);
+
+/**
+ * @brief Stops supervising the control ticks and hands the watchdog back to
+ * SysTick.
+ */
+void stop_supervisor(void);
+
+/**
+ * @brief Lengthens the watchdog timeout for blocking work outside runs.
+ * @param timeout_ms The time without a refresh after which the MCU is reset,
+ * in milliseconds (1 - 4095).
+ * @note Meant for work that stalls SysTick as well, such as flash erases.
+ * Call restore_watchdog() once it is done.
+ */
+void extend_watchdog(const uint16_t timeout_ms);
+
+/**
+ * @brief Restores the watchdog timeout after extend_watchdog().
+ */
+void restore_watchdog(void);
+
+/**
+ * @brief Records the completion of a control tick.
+ * @note Safe to call from the control timer interrupt. A tick finished past
+ * its deadline counts as an overrun, and after SUPERVISOR_MAX_OVERRUNS in a
+ * row the run is stopped through the state machine, so the running mode
+ * ramps the motors down and stops the turbine. On time ticks feed the
+ * watchdog, as long as the foreground loop has checked in since the last
+ * feed.
+ */
+void supervise_tick(void);
+
+/**
+ * @brief Signals that the foreground loop of the running mode is alive.
+ * @note If the foreground stalls, the watchdog stops being fed even if the
+ * control ticks keep running from an interrupt, and it resets the MCU.
+ */
+void supervise_foreground(void);
+
+#endif  // SUPERVISOR_H
@@ -0,0 +1,27 @@
+#ifndef SUPERVISOR_BASE_H
+#define SUPERVISOR_BASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SUPERVISOR_WATCHDOG_TIMEOUT_MS 50  // Reset after 50 ms without a feed
+#define SUPERVISOR_MAX_OVERRUNS 5  // Consecutive overruns before a safe-stop
+
+/**
+ * @struct Supervisor
+ * @brief Structure to hold the control tick deadline state and statistics.
+ */
+typedef struct {
+    bool active;                   // Control ticks are being supervised
+    bool tripped;                  // Safe-stop requested after overruns
+    bool watchdog_reset;           // Last MCU reset was caused by the watchdog
+    uint32_t period_us;            // Control tick period and deadline in us
+    uint64_t frame_start;          // Start of the pending tick frame in us
+    uint32_t ticks;                // Supervised control ticks
+    uint32_t overruns;             // Ticks finished past their deadline
+    uint8_t consecutive_overruns;  // Current run of overrunning ticks
+    uint8_t longest_overrun_run;   // Longest run of overrunning ticks
+    uint32_t max_lateness_us;      // Longest time past a deadline in us
+} Supervisor;
+
+#endif  // SUPERVISOR_BASE_H
@@ -0,0 +1,93 @@
+#include "supervisor/supervisor.h"
+
+#include "hal/watchdog.h"
+#include "state_machine/handlers/config_handler.h"
+#include "timer/time.h"
+
+static Supervisor supervisor = {0};
+static volatile bool foreground_alive = false;
+
+static void record_overruns(const uint32_t count, const uint64_t lateness) {
+    if (lateness > supervisor.max_lateness_us) {
+        supervisor.max_lateness_us =
+            lateness > UINT32_MAX ? UINT32_MAX : (uint32_t)lateness;
+    }
+
+    supervisor.overruns += count;
+    const uint32_t run = supervisor.consecutive_overruns + count;
+    supervisor.consecutive_overruns = run > UINT8_MAX ? UINT8_MAX : run;
+    if (supervisor.consecutive_overruns > supervisor.longest_overrun_run) {
+        supervisor.longest_overrun_run = supervisor.consecutive_overruns;
+    }
+
+    if (supervisor.consecutive_overruns < SUPERVISOR_MAX_OVERRUNS) return;
+    if (supervisor.tripped) return;
+
+    // Leave the control loop so the running mode performs its stop sequence
+    supervisor.tripped = true;
+    set_can_run(false);
+}
+
+const Supervisor* init_supervisor(void) {
+    supervisor = (Supervisor){0};
+    supervisor.watchdog_reset = watchdog_caused_reset();
+
+    init_watchdog(SUPERVISOR_WATCHDOG_TIMEOUT_MS);
+    return &supervisor;
+}
+
+const Supervisor* get_supervisor(void) { return &supervisor; }
+
+void start_supervisor(const uint32_t period_us) {
+    supervisor.tripped = false;
+    supervisor.period_us = period_us;
+    supervisor.ticks = 0;
+    supervisor.overruns = 0;
+    supervisor.consecutive_overruns = 0;
+    supervisor.longest_overrun_run = 0;
+    supervisor.max_lateness_us = 0;
+    supervisor.frame_start = time_us64();
+
+    foreground_alive = true;
+    set_watchdog_keepalive(false);
+    supervisor.active = true;
+}
+
+void stop_supervisor(void) {
+    supervisor.active = false;
+    set_watchdog_keepalive(true);
+}
+
+void extend_watchdog(const uint16_t timeout_ms) {
+    feed_watchdog();
+    init_watchdog(timeout_ms);
+}
+
+void restore_watchdog(void) { init_watchdog(SUPERVISOR_WATCHDOG_TIMEOUT_MS); }
+
+void supervise_tick(void) {
+    if (!supervisor.active) return;
+
+    const uint64_t now = time_us64();
+    const uint64_t deadline = supervisor.frame_start + supervisor.period_us;
+    supervisor.ticks++;
+    supervisor.frame_start = deadline;
+
+    if (now <= deadline) {
+        supervisor.consecutive_overruns = 0;
+
+        if (foreground_alive) {
+            foreground_alive = false;
+            feed_watchdog();
+        }
+        return;
+    }
+
+    // Frames that passed without any tick missed their deadline as well
+    const uint64_t skipped = (now - deadline) / supervisor.period_us;
+    supervisor.frame_start += skipped * supervisor.period_us;
+
+    record_overruns(1 + (uint32_t)skipped, now - deadline);
+}
+
+void supervise_foreground(void) { foreground_alive = true; }
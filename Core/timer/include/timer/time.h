@@ -4,8 +4,11 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#define US_PER_MS 1000ULL
+
 /**
- * @brief Initializes the timer module and system timer (SysTick).
+ * @brief Initializes the timer module, the system timer (SysTick) and the
+ * microsecond timebase (TIM5).
  */
 void init_timer(void);
 
@@ -25,6 +28,15 @@ uint32_t time(void);
  */
 uint32_t time_us(void);
 
+/**
+ * @brief Returns the monotonic system time in microseconds.
+ *
+ * @return The time since startup in microseconds.
+ * @note Never wraps in practice (2^64 us), so differences between any two
+ * readings are valid. Prefer this for timestamps kept across long runs.
+ */
+uint64_t time_us64(void);
+
 /**
  * @brief Checks if a specified duration has elapsed since a given start time.
  *
@@ -44,6 +56,46 @@ bool time_elapsed(const uint32_t start, const uint32_t duration);
  */
 bool time_elapsed_us(const uint32_t start, const uint32_t duration);
 
+/**
+ * @brief Checks if a specified duration has elapsed since a given monotonic
+ * start time.
+ *
+ * @param start The start time in microseconds, from time_us64().
+ * @param duration The duration in microseconds to check against.
+ * @return true if the interval has elapsed, false otherwise.
+ */
+bool time_elapsed_us64(const uint64_t start, const uint64_t duration);
+
+/**
+ * @brief Advances the start time of a periodic frame by one period.
+ *
+ * @param start The start time of the current frame in microseconds, from
+ * time_us64().
+ * @param period The frame period in microseconds.
+ * @return The start time of the next frame in microseconds.
+ * @note Frames keep their phase so late updates don't drift the rate, but if a
+ * whole frame was missed the next one starts from the current time instead of
+ * running back to back.
+ */
+uint64_t advance_period_us64(const uint64_t start, const uint64_t period);
+
+/**
+ * @brief Returns a deadline a specified duration from now.
+ *
+ * @param duration The duration in microseconds until the deadline.
+ * @return The deadline as a monotonic time in microseconds.
+ */
+uint64_t deadline_us(const uint64_t duration);
+
+/**
+ * @brief Checks if a deadline has been reached.
+ *
+ * @param deadline The deadline as a monotonic time in microseconds.
+ * @return true if the current time is at or past the deadline, false
+ * otherwise.
+ */
+bool deadline_reached(const uint64_t deadline);
+
 /**
  * @brief Delays execution for a specified number of milliseconds.
  *
@@ -8,6 +8,8 @@ uint32_t time(void) { return get_system_time(); }
 
 uint32_t time_us(void) { return get_system_time_us(); }
 
+uint64_t time_us64(void) { return get_system_time_us64(); }
+
 bool time_elapsed(const uint32_t start, const uint32_t duration) {
     return time_elapsed_ms(start, duration);
 }
@@ -16,6 +18,25 @@ bool time_elapsed_us(const uint32_t start, const uint32_t duration) {
     return (get_system_time_us() - start) >= duration;
 }
 
+bool time_elapsed_us64(const uint64_t start, const uint64_t duration) {
+    return (get_system_time_us64() - start) >= duration;
+}
+
+uint64_t advance_period_us64(const uint64_t start, const uint64_t period) {
+    const uint64_t now = get_system_time_us64();
+    const uint64_t next = start + period;
+
+    return now >= next + period ? now : next;
+}
+
+uint64_t deadline_us(const uint64_t duration) {
+    return get_system_time_us64() + duration;
+}
+
+bool deadline_reached(const uint64_t deadline) {
+    return get_system_time_us64() >= deadline;
+}
+
 void delay(const uint32_t ms) { delay_ms(ms); }
 
 void delay_us(const uint32_t us) {
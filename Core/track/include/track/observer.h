@@ -15,35 +15,34 @@ void init_observer(const ErrorStruct* const error_struct);
 
 /**
  * @brief Checks if the line is detected by any of the central sensors.
+ * @param frame The sensor frame to check.
  * @return LostType indicating the type of line loss (NONE, LEFT, RIGHT, PITCH).
  */
-LostType check_line(void);
+LostType check_line(const SensorFrame* const frame);
 
 /**
  * @brief Checks if the active sensors are non-contiguous.
+ * @param frame The sensor frame to check.
  * @return true if non-contiguous sensors are detected, false otherwise.
  */
-bool check_non_contiguous_sensors(void);
+bool check_non_contiguous_sensors(const SensorFrame* const frame);
 
 /**
  * @brief Checks if a crossing is detected based on the number of active
  * central sensors.
+ * @param frame The sensor frame to check.
  * @return true if a crossing is detected, false otherwise.
  */
-bool check_crossing(void);
+bool check_crossing(const SensorFrame* const frame);
 
 /**
- * @brief Checks if a curve marker is detected based on side sensor states and
- * error threshold.
- * @return true if a curve marker is detected, false otherwise.
+ * @brief Checks the side sensor pulses completed since the last call for a
+ * marker.
+ * @param frame The sensor frame pulse lengths are measured from.
+ * @return CURVE_MARKER for a left pulse and TRACK_MARKER for a right one,
+ * NO_MARKER if no pulse had a marker's length while centered on the line.
+ * @note Pulses seen by both side sensors at once are crossings, not markers.
  */
-bool check_curve_marker(void);
-
-/**
- * @brief Checks if a track marker is detected based on side sensor states and
- * error threshold.
- * @return true if a track marker is detected, false otherwise.
- */
-bool check_track_marker(void);
+SideMarkers check_side_marker(const SensorFrame* const frame);
 
 #endif  // OBSERVER_H
@@ -9,6 +9,12 @@
  */
 typedef enum { NONE, LEFT, RIGHT, PITCH } LostType;
 
+/**
+ * @enum SideMarkers
+ * @brief Enumeration for the side markers passed by the robot.
+ */
+typedef enum { NO_MARKER, CURVE_MARKER, TRACK_MARKER } SideMarkers;
+
 /**
  * @struct TrackCounters
  * @brief Structure to hold tracking counters for different line observations.
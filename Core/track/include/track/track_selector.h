@@ -25,4 +25,8 @@
 #include "track/tracks/base_square.h"
 #endif
 
+#ifndef WAYPOINT_UNIT_CM
+#define WAYPOINT_UNIT_CM 1.0f  // Waypoint tables are in cm unless stated
+#endif
+
 #endif  // TRACK_SELECTOR_H
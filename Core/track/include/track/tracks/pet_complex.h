@@ -1,6 +1,7 @@
 #ifndef TRACK_PET_COMPLEX_H
 #define TRACK_PET_COMPLEX_H
 
+#define WAYPOINT_UNIT_CM 0.1f  // Recorded by odometry in mm
 #define WAYPOINT_COUNT 6279
 
 extern const float waypoints_x[WAYPOINT_COUNT];
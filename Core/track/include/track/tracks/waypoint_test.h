@@ -1,6 +1,7 @@
 #ifndef TRACK_WAYPOINT_TEST_H
 #define TRACK_WAYPOINT_TEST_H
 
+#define WAYPOINT_UNIT_CM 0.1f  // Recorded by odometry in mm
 #define WAYPOINT_COUNT 1554
 
 extern const float waypoints_x[WAYPOINT_COUNT];
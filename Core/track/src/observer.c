@@ -3,23 +3,25 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-// Minimum number of sensors for crossing detection
-#define CROSSING_SENSORS_THRESHOLD 4
+#include "hal/ir_sensors.h"
+#include "pid/errors/errors.h"
+#include "sensors/markers.h"
 
 // Threshold for max error possible in a side marker detection
 #define SIDE_MARKERS_ERROR_THRESHOLD 4
 
+// Side pulse lengths accepted as markers, longer ones see the line itself
+#define MARKER_MIN_LENGTH_MM 10.0f
+#define MARKER_MAX_LENGTH_MM 60.0f
+
 static const ErrorStruct* errors = NULL;
-static uint8_t total_sensors = 0;
 
 void init_observer(const ErrorStruct* const error_struct) {
     errors = error_struct;
-    total_sensors = errors->sensors->ir_sensors->total_central_sensors;
 }
 
-LostType check_line(void) {
-    const uint8_t central_sensors =
-        errors->sensors->ir_sensors->central_sensors_state;
+LostType check_line(const SensorFrame* const frame) {
+    const uint8_t central_sensors = frame->ir_sensors.central_sensors_state;
 
     if (central_sensors != 0) return NONE;
     if (errors->error <= errors->min_error) return LEFT;
@@ -27,55 +29,30 @@ LostType check_line(void) {
     return PITCH;
 }
 
-bool check_non_contiguous_sensors(void) {
-    bool found_active = false;
-    bool found_gap = false;
-
-    const uint8_t central_sensors =
-        errors->sensors->ir_sensors->central_sensors_state;
-
-    for (uint8_t i = 0; i < total_sensors; i++) {
-        if (central_sensors & (1 << i)) {
-            if (found_gap) return true;
-            found_active = true;
-        } else if (found_active) {
-            found_gap = true;  // Gap found after active sensors
-        }
-    }
+bool check_non_contiguous_sensors(const SensorFrame* const frame) {
+    const uint8_t central_sensors = frame->ir_sensors.central_sensors_state;
 
-    return false;
+    return !get_line_features(central_sensors)->contiguous;
 }
 
-bool check_crossing(void) {
-    const uint8_t central_sensors =
-        errors->sensors->ir_sensors->central_sensors_state;
+bool check_crossing(const SensorFrame* const frame) {
+    const uint8_t central_sensors = frame->ir_sensors.central_sensors_state;
 
-    uint8_t active_count = 0;
-    for (uint8_t i = 0; i < total_sensors; i++) {
-        if (central_sensors & (1 << i)) {
-            active_count++;
-        }
-    }
-
-    return active_count >= CROSSING_SENSORS_THRESHOLD;
+    return get_line_features(central_sensors)->crossing;
 }
 
-bool check_curve_marker(void) {
-    if (!errors->sensors->ir_sensors->left_sensor ||
-        errors->sensors->ir_sensors->right_sensor ||
-        abs(errors->error) >= SIDE_MARKERS_ERROR_THRESHOLD) {
-        return false;
-    }
+SideMarkers check_side_marker(const SensorFrame* const frame) {
+    SidePulse pulse;
 
-    return true;
-}
+    while (read_side_pulse(&pulse, frame)) {
+        if (pulse.overlapped || pulse.length_mm < MARKER_MIN_LENGTH_MM ||
+            pulse.length_mm > MARKER_MAX_LENGTH_MM ||
+            abs(errors->error) >= SIDE_MARKERS_ERROR_THRESHOLD) {
+            continue;
+        }
 
-bool check_track_marker(void) {
-    if (!errors->sensors->ir_sensors->right_sensor ||
-        errors->sensors->ir_sensors->left_sensor ||
-        abs(errors->error) >= SIDE_MARKERS_ERROR_THRESHOLD) {
-        return false;
+        return pulse.sensor == LEFT_SIDE_SENSOR ? CURVE_MARKER : TRACK_MARKER;
     }
 
-    return true;
+    return NO_MARKER;
 }
@@ -6,18 +6,18 @@
 
 #include "logger/logger.h"
 #include "math/math.h"
+#include "sensors/sensors.h"
 #include "timer/time.h"
 #include "track/observer.h"
 
 #define MIN_ARC_ANGLE_RAD 0.3f
 #define IMU_FUSION_ALPHA 1.0f
 #define DETECTION_DEBOUNCE_TIME_MS 30
-#define MARKER_COUNTER_THRESHOLD 12
 #define CROSSING_COUNTER_THRESHOLD 1
 
 static TrackCounters track = {0};
 
-static const ErrorStruct* errors = NULL;
+static SensorFrame track_frame = {0};
 static uint32_t last_true_check_time = 0;
 static float prev_mpu_yaw = 0.0f;
 static bool heading_vec_initialized = false;
@@ -82,14 +82,14 @@ static inline void anchor_heading_vector(const float heading) {
 }
 
 // TODO: Add distance resets based on markers
-static inline void update_distance(void) {
-    track.distance += errors->sensors->encoders->current_distance;
+static inline void update_distance(const SensorFrame* const frame) {
+    track.distance += frame->encoders.current_distance;
     if (track.distance < 0) track.distance = 0;
 }
 
-static inline float get_delta_angle(void) {
-    const float enc_angle = errors->sensors->encoders->current_angle;
-    const float current_yaw = errors->sensors->mpu_data->yaw;
+static inline float get_delta_angle(const SensorFrame* const frame) {
+    const float enc_angle = frame->encoders.current_angle;
+    const float current_yaw = frame->mpu_data.yaw;
 
     float delta_yaw = current_yaw - prev_mpu_yaw;
     normalize_angle(&delta_yaw);
@@ -99,13 +99,13 @@ static inline float get_delta_angle(void) {
 }
 
 // TODO: Add XY resets based on markers
-static inline void update_position(void) {
-    const float dist = errors->sensors->encoders->current_distance;
-    const float angle = get_delta_angle();
+static inline void update_position(const SensorFrame* const frame) {
+    const float dist = frame->encoders.current_distance;
+    const float angle = get_delta_angle(frame);
     const float half_step = 0.5f * angle;
 
     if (!heading_vec_initialized) {
-        anchor_heading_vector(errors->sensors->mpu_data->yaw - angle);
+        anchor_heading_vector(frame->mpu_data.yaw - angle);
     }
 
     float s_half, c_half;
@@ -137,7 +137,7 @@ static inline void update_position(void) {
 }
 
 static inline void update_line(void) {
-    switch (check_line()) {
+    switch (check_line(&track_frame)) {
         case NONE:
             track.line_counter++;
             break;
@@ -162,11 +162,7 @@ static bool check_memory(const MemoryCounters counter_type) {
 
     memory.counter++;
 
-    if (counter_type == CROSSING &&
-        memory.counter < CROSSING_COUNTER_THRESHOLD) {
-        return false;
-    }
-    if (memory.counter < MARKER_COUNTER_THRESHOLD) return false;
+    if (memory.counter < CROSSING_COUNTER_THRESHOLD) return false;
 
     reset_memory();
     return true;
@@ -189,7 +185,8 @@ static inline void update_section_for_markers(void) {
 }
 
 static inline bool process_event(const MemoryCounters event) {
-    if (!check_memory(event)) return false;
+    // Side markers arrive as whole pulses, only crossings span frames
+    if (event == CROSSING && !check_memory(event)) return false;
 
     last_true_check_time = time();
 
@@ -213,22 +210,26 @@ static inline bool process_event(const MemoryCounters event) {
 }
 
 static inline bool update_track_counters(void) {
+    switch (check_side_marker(&track_frame)) {
+        case CURVE_MARKER:
+            return process_event(CURVE);
+        case TRACK_MARKER:
+            return process_event(MARKER);
+        default:
+            break;
+    }
+
     if (!time_elapsed(last_true_check_time, DETECTION_DEBOUNCE_TIME_MS)) {
         return false;
     }
 
-    if (check_non_contiguous_sensors()) return false;
-
-    if (check_crossing() && process_event(CROSSING)) return true;
-    if (check_curve_marker() && process_event(CURVE)) return true;
-    if (check_track_marker() && process_event(MARKER)) return true;
+    if (check_non_contiguous_sensors(&track_frame)) return false;
 
-    return false;
+    return check_crossing(&track_frame) && process_event(CROSSING);
 }
 
 const TrackCounters* init_track(const ErrorStruct* const error_struct) {
     init_observer(error_struct);
-    errors = error_struct;
     track.imu_alpha = IMU_FUSION_ALPHA;
 
     return &track;
@@ -245,19 +246,23 @@ void reset_track(void) {
     reset_memory();
 }
 
+static inline void update_odometry(void) {
+    update_distance(&track_frame);
+    update_position(&track_frame);
+}
+
 bool update_track(const bool encoder_updated) {
-    if (encoder_updated) {
-        update_distance();
-        update_position();
-    }
+    // The control timer may publish several frames while this runs
+    copy_sensor_frame(&track_frame);
+    if (encoder_updated) update_odometry();
 
     update_line();
     return update_track_counters();
 }
 
 void update_positions(void) {
-    update_distance();
-    update_position();
+    copy_sensor_frame(&track_frame);
+    update_odometry();
 }
 
 void set_imu_alpha(const float alpha) { track.imu_alpha = alpha; }
@@ -8,13 +8,12 @@ static bool turbine_waiting = false;
 static uint32_t turbine_start_time = 0;
 
 void set_turbine_pwm(const uint16_t pwm) {
-    if (pwm > MAX_PWM) {
-        turbine_pwm = MAX_PWM;
-    } else if (pwm < MIN_PWM) {
-        turbine_pwm = MIN_PWM;
-    } else {
-        turbine_pwm = pwm;
-    }
+    turbine_pwm = pwm > MAX_PWM ? MAX_PWM : pwm;
+
+    // Unsigned values are already above a zero minimum
+#if MIN_PWM > 0
+    if (turbine_pwm < MIN_PWM) turbine_pwm = MIN_PWM;
+#endif
 }
 
 uint16_t get_turbine_pwm(void) { return turbine_pwm; }
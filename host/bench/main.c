@@ -0,0 +1,270 @@
+#include <libgen.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim/report.h"
+
+#define ROW_SIZE 256
+#define NAME_SIZE 32
+#define MAX_ROWS 64
+#define DEFAULT_OUTPUT "bench_results.csv"
+#define DEFAULT_TOLERANCE 2.0f  // Allowed lap time increase in percent
+
+// Columns of SIM_CSV_HEADER used for the comparison
+#define COLUMN_TRACK 0
+#define COLUMN_MODE 1
+#define COLUMN_STATUS 2
+#define COLUMN_LAP_TIME 4
+#define COLUMN_RMS_CROSS_TRACK 8
+
+/**
+ * @struct BenchRow
+ * @brief Fields of a report row compared against the baseline.
+ */
+typedef struct {
+    char track[NAME_SIZE];
+    char mode[NAME_SIZE];
+    char status[NAME_SIZE];
+    unsigned lap_time_ms;
+    float rms_cross_track;
+} BenchRow;
+
+// Must follow the BENCH_TRACKS list in CMakeLists.txt
+static const char* const TRACKS[] = {
+    "base_square", "inverse_square", "base_triangle",
+    "inverse_triangle", "star", "heart",
+    "pet", "pet_complex", "waypoint_test",
+};
+
+static const char* const MODES[] = {"pid", "pure_pursuit"};
+
+#define TRACK_COUNT (sizeof(TRACKS) / sizeof(TRACKS[0]))
+#define MODE_COUNT (sizeof(MODES) / sizeof(MODES[0]))
+
+static void print_usage(const char* const name) {
+    fprintf(stderr,
+            "Usage: %s [-o results.csv] [-b baseline.csv] [-t tolerance_%%] "
+            "[-l laps] [-d]\n",
+            name);
+}
+
+static bool get_sim_dir(char* const dir, const size_t size) {
+    char path[PATH_MAX];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0) return false;
+
+    path[length] = '\0';
+    snprintf(dir, size, "%s", dirname(path));
+    return true;
+}
+
+static bool parse_row(const char* const line, BenchRow* const row) {
+    char copy[ROW_SIZE];
+    char* fields[SIM_CSV_COLUMNS] = {0};
+    uint8_t count = 0;
+
+    snprintf(copy, sizeof(copy), "%s", line);
+    copy[strcspn(copy, "\r\n")] = '\0';
+
+    for (char* field = strtok(copy, ","); field && count < SIM_CSV_COLUMNS;
+         field = strtok(NULL, ",")) {
+        fields[count++] = field;
+    }
+    // Reports from older builds may lack the trailing columns
+    if (count <= COLUMN_RMS_CROSS_TRACK) return false;
+
+    snprintf(row->track, sizeof(row->track), "%s", fields[COLUMN_TRACK]);
+    snprintf(row->mode, sizeof(row->mode), "%s", fields[COLUMN_MODE]);
+    snprintf(row->status, sizeof(row->status), "%s", fields[COLUMN_STATUS]);
+    row->lap_time_ms = (unsigned)strtoul(fields[COLUMN_LAP_TIME], NULL, 10);
+    row->rms_cross_track = strtof(fields[COLUMN_RMS_CROSS_TRACK], NULL);
+
+    return true;
+}
+
+static uint8_t load_rows(const char* const path, BenchRow* const rows) {
+    FILE* const file = fopen(path, "r");
+    if (!file) return 0;
+
+    char line[ROW_SIZE];
+    uint8_t count = 0;
+
+    while (count < MAX_ROWS && fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "track,", 6) == 0) continue;  // Header
+        if (parse_row(line, &rows[count])) count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+static const BenchRow* find_row(const BenchRow* const rows,
+                                const uint8_t count, const BenchRow* const row) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp(rows[i].track, row->track) == 0 &&
+            strcmp(rows[i].mode, row->mode) == 0) {
+            return &rows[i];
+        }
+    }
+
+    return NULL;
+}
+
+static bool run_sim(const char* const dir, const char* const track,
+                    const char* const mode, const unsigned laps,
+                    const bool drift, char* const line, const size_t size) {
+    char command[PATH_MAX + 64];
+    snprintf(command, sizeof(command),
+             "'%s/line_follower_sim_%s' %s %u%s --csv", dir, track, mode, laps,
+             drift ? " --drift" : "");
+
+    FILE* const pipe = popen(command, "r");
+    if (!pipe) return false;
+
+    const bool read = fgets(line, (int)size, pipe) != NULL;
+    pclose(pipe);  // Unfinished runs exit with failure but still report
+
+    return read;
+}
+
+static inline bool is_finished(const BenchRow* const row) {
+    return strcmp(row->status, "finished") == 0;
+}
+
+// A run that didn't finish has no lap time to compare, so it always fails
+static void report_unfinished(const BenchRow* const row,
+                              const BenchRow* const baseline) {
+    if (baseline && is_finished(baseline)) {
+        printf("REGRESSION %s/%s: %s, baseline finished in %u ms\n",
+               row->track, row->mode, row->status, baseline->lap_time_ms);
+    } else {
+        printf("UNFINISHED %s/%s: %s\n", row->track, row->mode, row->status);
+    }
+}
+
+static bool compare_row(const BenchRow* const row,
+                        const BenchRow* const baseline,
+                        const float tolerance) {
+    if (!is_finished(baseline)) {
+        printf("fixed      %s/%s: %u ms (baseline %s)\n", row->track,
+               row->mode, row->lap_time_ms, baseline->status);
+        return true;
+    }
+
+    const float change =
+        100.0f * ((float)row->lap_time_ms - (float)baseline->lap_time_ms) /
+        (float)baseline->lap_time_ms;
+    const bool regressed = change > tolerance;
+
+    printf("%s %s/%s: %u ms (baseline %u ms, %+.2f%%), rms %.3f cm "
+           "(baseline %.3f cm)\n",
+           regressed ? "REGRESSION" : "ok        ", row->track, row->mode,
+           row->lap_time_ms, baseline->lap_time_ms, (double)change,
+           (double)row->rms_cross_track, (double)baseline->rms_cross_track);
+
+    return !regressed;
+}
+
+int main(int argc, char** argv) {
+    const char* output_path = DEFAULT_OUTPUT;
+    const char* baseline_path = NULL;
+    float tolerance = DEFAULT_TOLERANCE;
+    unsigned laps = 1;
+    bool drift = false;
+
+    int option;
+    while ((option = getopt(argc, argv, "o:b:t:l:d")) != -1) {
+        switch (option) {
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'b':
+                baseline_path = optarg;
+                break;
+            case 't':
+                tolerance = strtof(optarg, NULL);
+                break;
+            case 'l':
+                laps = (unsigned)strtoul(optarg, NULL, 10);
+                break;
+            case 'd':
+                drift = true;
+                break;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    static BenchRow baseline[MAX_ROWS];
+    uint8_t baseline_count = 0;
+    if (baseline_path) {
+        baseline_count = load_rows(baseline_path, baseline);
+        if (!baseline_count) {
+            fprintf(stderr, "Failed to read baseline %s\n", baseline_path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char sim_dir[PATH_MAX];
+    if (!get_sim_dir(sim_dir, sizeof(sim_dir))) {
+        fprintf(stderr, "Failed to locate the track simulators\n");
+        return EXIT_FAILURE;
+    }
+
+    FILE* const output = fopen(output_path, "w");
+    if (!output) {
+        fprintf(stderr, "Failed to open %s\n", output_path);
+        return EXIT_FAILURE;
+    }
+    fprintf(output, "%s\n", SIM_CSV_HEADER);
+
+    bool passed = true;
+
+    for (uint8_t i = 0; i < TRACK_COUNT; i++) {
+        for (uint8_t j = 0; j < MODE_COUNT; j++) {
+            char line[ROW_SIZE];
+            BenchRow row;
+
+            fprintf(stderr, "Running %s/%s...\n", TRACKS[i], MODES[j]);
+            if (!run_sim(sim_dir, TRACKS[i], MODES[j], laps, drift, line,
+                         sizeof(line)) ||
+                !parse_row(line, &row)) {
+                fprintf(stderr, "Simulator for %s/%s failed\n", TRACKS[i],
+                        MODES[j]);
+                passed = false;
+                continue;
+            }
+
+            fputs(line, output);
+            fflush(output);
+
+            const BenchRow* const reference =
+                baseline_count ? find_row(baseline, baseline_count, &row)
+                               : NULL;
+            if (!is_finished(&row)) {
+                report_unfinished(&row, reference);
+                passed = false;
+                continue;
+            }
+
+            if (!baseline_count) continue;
+            if (!reference) {
+                printf("new        %s/%s: %s, %u ms\n", row.track, row.mode,
+                       row.status, row.lap_time_ms);
+                continue;
+            }
+
+            if (!compare_row(&row, reference, tolerance)) passed = false;
+        }
+    }
+
+    fclose(output);
+    fprintf(stderr, "Results written to %s\n", output_path);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
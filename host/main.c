@@ -0,0 +1,12 @@
+#include "hal/host/clock.h"
+#include "hal/host/registers.h"
+#include "state_machine/state_machine.h"
+
+int main(void) {
+    reset_host_registers();
+    set_host_clock_mode(HOST_CLOCK_REALTIME);
+
+    run_state_machine();
+
+    return 0;
+}
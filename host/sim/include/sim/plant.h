@@ -0,0 +1,29 @@
+#ifndef SIM_PLANT_H
+#define SIM_PLANT_H
+
+#include "sim/sim_base.h"
+
+/**
+ * @brief Places the robot on the track and resets its dynamics.
+ * @param config Pointer to the simulation parameters.
+ * @param arc Arc length of the starting point of the sensor bar in cm.
+ * @return Pointer to the ground truth state of the robot.
+ * @note The track map must be initialized before the plant.
+ */
+const SimPlant* init_plant(const SimConfig* const config, const float arc);
+
+/**
+ * @brief Gets the ground truth state of the robot.
+ * @return Pointer to the ground truth state of the robot.
+ */
+const SimPlant* get_plant(void);
+
+/**
+ * @brief Advances the robot dynamics and refreshes the simulated sensors.
+ * @param dt Time step in seconds.
+ * @note Reads the motor PWM and directions from the host registers and writes
+ * back the encoder counters, MPU registers, IR discharge times and side pins.
+ */
+void update_plant(const float dt);
+
+#endif  // SIM_PLANT_H
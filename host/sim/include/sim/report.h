@@ -0,0 +1,49 @@
+#ifndef SIM_REPORT_H
+#define SIM_REPORT_H
+
+#include <stdio.h>
+
+#include "sim/sim_base.h"
+
+// Columns of the machine-readable run reports, in output order
+#define SIM_CSV_HEADER                                                   \
+    "track,mode,status,laps,lap_time_ms,run_time_ms,distance_cm,"        \
+    "max_cross_track_cm,rms_cross_track_cm,lost_left,lost_right,"        \
+    "lost_pitch,control_ticks,tick_period_us,cpu_ns_per_tick,"           \
+    "max_heading_error_deg"
+
+#define SIM_CSV_COLUMNS 16  // Number of columns in SIM_CSV_HEADER
+
+/**
+ * @brief Gets the track the simulator was built for.
+ * @return Pointer to the real size of SELECTED_TRACK.
+ */
+const SimTrack* get_sim_track(void);
+
+/**
+ * @brief Gets the name of the track the simulator was built for.
+ * @return The lowercase name of SELECTED_TRACK.
+ */
+const char* get_sim_track_name(void);
+
+/**
+ * @brief Gets a short description of how a run ended.
+ * @param result Pointer to the outcome of the run.
+ * @return "finished", "stopped", "off_track" or "timed_out".
+ * @note A run only finishes once the firmware stops after the requested laps
+ * without a safe-stop. Any other stop is reported as "stopped".
+ */
+const char* get_sim_status(const SimResult* const result);
+
+/**
+ * @brief Writes the outcome of a run as a single CSV row.
+ * @param file The stream to write to.
+ * @param mode The name of the running mode used in the run.
+ * @param result Pointer to the outcome of the run.
+ * @note The columns follow SIM_CSV_HEADER. The lap time is the mean of the
+ * completed laps, or 0 if none was completed.
+ */
+void write_sim_csv_row(FILE* const file, const char* const mode,
+                       const SimResult* const result);
+
+#endif  // SIM_REPORT_H
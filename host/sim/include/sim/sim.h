@@ -0,0 +1,45 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+#include "serial/serial_base.h"
+#include "sim/sim_base.h"
+
+/**
+ * @brief Gets the default simulation parameters.
+ * @return Parameters approximating the robot hardware.
+ */
+SimConfig get_default_sim_config(void);
+
+/**
+ * @brief Builds the track of the selected waypoint table and places the robot
+ * at its start.
+ * @param config Pointer to the simulation parameters.
+ * @return true if the simulation is ready to run, false if the track could not
+ * be built or its size is more than 25% off the real track.
+ * @note The robot starts on the point of the track closest to the odometry
+ * origin, facing along the track, with the start marker ahead of it and the
+ * finish marker behind it.
+ */
+bool init_sim(const SimConfig* const config);
+
+/**
+ * @brief Queues a serial command for the firmware, as sent by the app.
+ * @param msg The message to send.
+ * @param payload Pointer to the message payload, or NULL if it has none.
+ * @return true if the command was queued, false otherwise.
+ */
+bool send_sim_command(const SerialMessages msg, const uint8_t* const payload);
+
+/**
+ * @brief Runs the firmware state machine against the simulated robot.
+ * @return Pointer to the outcome of the run.
+ * @note Runs on the virtual clock, so it is not bound to real time. The run
+ * ends when the firmware leaves RUNNING, the robot leaves the track or the
+ * time limit is reached. The firmware is not re-entrant, so it must only be
+ * run once per process.
+ */
+const SimResult* run_sim(void);
+
+#endif  // SIM_H
@@ -0,0 +1,105 @@
+#ifndef SIM_BASE_H
+#define SIM_BASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SIM_MAX_LAPS 16  // Maximum number of lap times recorded per run
+
+/**
+ * @struct SimConfig
+ * @brief Physical and run parameters of the simulated robot and track.
+ * @note Lengths are in cm to match the waypoint tables and TrackCounters.
+ * Side sensors ignore the line by default, since waypoint tables recorded over
+ * several passes draw neighbouring lines the real track does not have.
+ */
+typedef struct {
+    float wheel_base;          // Distance between the wheels in cm
+    float max_wheel_speed;     // Wheel speed at MAX_PWM in cm/s
+    float motor_time_constant; // First order motor response in seconds
+    float sensor_offset;       // Sensor bar distance ahead of the axle in cm
+    float sensor_pitch;        // Distance between central sensors in cm
+    float sensor_radius;       // Radius of each sensor footprint in cm
+    float side_sensor_offset;  // Lateral offset of the side sensors in cm
+    bool side_sensors_see_line;  // Side sensors also trigger over the line
+    float line_width;          // Width of the track line in cm
+    float marker_offset;       // Lateral offset of the side markers in cm
+    float marker_length;       // Length of the side markers in cm
+    float marker_width;        // Width of the side markers in cm
+    float start_marker_offset; // Start/finish markers distance from start
+    uint16_t white_discharge_us;  // Discharge time of a sensor over the line
+    uint16_t black_discharge_us;  // Discharge time of a sensor off the line
+    float gyro_bias;           // Gyroscope Z bias in deg/s
+    float gyro_noise;          // Gyroscope Z noise amplitude in deg/s
+    float temperature;         // MPU die temperature in °C
+    float gyro_bias_ramp;      // Gyroscope Z bias drift in deg/s per minute
+    float temperature_ramp;    // MPU die temperature drift in °C per minute
+    float off_track_distance;  // Distance from the line that aborts the run
+    uint32_t step_us;          // Physics step in µs
+    uint32_t clock_read_ns;    // Virtual time consumed by each clock read
+    uint32_t max_time_ms;      // Simulated time limit of the run in ms
+    uint32_t seed;             // Seed for the sensor noise generator
+} SimConfig;
+
+/**
+ * @struct SimTrack
+ * @brief Size of a bundled track as laid out for real.
+ * @note Tables recorded over several passes count every pass in the length.
+ */
+typedef struct {
+    const char* name;  // Lowercase name of the track
+    float width;       // Bounding box extent along X in cm
+    float height;      // Bounding box extent along Y in cm
+    float length;      // Centerline length of the whole table in cm
+} SimTrack;
+
+/**
+ * @struct SimPlant
+ * @brief Ground truth state of the simulated robot.
+ */
+typedef struct {
+    float x;            // X position of the axle center in cm
+    float y;            // Y position of the axle center in cm
+    float heading;      // Heading in radians, counter-clockwise positive
+    float left_speed;   // Left wheel speed in cm/s
+    float right_speed;  // Right wheel speed in cm/s
+    float yaw_rate;     // Yaw rate in rad/s
+    float distance;     // Distance traveled by the axle center in cm
+    float cross_track;  // Sensor bar distance from the line in cm, left > 0
+    float progress;     // Arc length of the sensor bar along the track in cm
+} SimPlant;
+
+/**
+ * @struct SimResult
+ * @brief Outcome of a simulated run.
+ */
+typedef struct {
+    uint64_t sim_time_us;                // Simulated time at the end of the run
+    uint32_t run_time_ms;                // Time spent driving in RUNNING
+    uint8_t laps;                        // Laps completed by the firmware
+    uint32_t lap_times_ms[SIM_MAX_LAPS]; // Lap times from marker to marker
+    float distance;                      // Ground truth distance in cm
+    float max_cross_track;               // Peak absolute cross-track error
+    float rms_cross_track;               // RMS cross-track error in cm
+    uint32_t cross_track_samples;        // Samples used for the error stats
+    float max_heading_error;             // Peak gyro yaw error in degrees
+    uint8_t lost_left;                   // Firmware lost left counter
+    uint8_t lost_right;                  // Firmware lost right counter
+    uint8_t lost_pitch;                  // Firmware lost pitch counter
+    uint32_t control_ticks;              // Central sensor reads while driving
+    float tick_period_us;                // Mean simulated control period
+    float cpu_ns_per_tick;               // Host CPU time in the firmware,
+                                         // without the virtual clock
+    uint32_t deadline_overruns;          // Control ticks past their deadline
+    uint32_t watchdog_expiries;          // Late watchdog refreshes
+    uint16_t first_sample_us;            // PID frame sample point at start
+    uint16_t last_sample_us;             // PID frame sample point at the end
+    uint16_t min_frame_us;               // Shortest PID frame at the end
+    bool safe_stopped;                   // The supervisor stopped the run
+    bool stopped;                        // The firmware left RUNNING
+    bool finished;                       // Stopped after the requested laps
+    bool off_track;                      // The robot left the track
+    bool timed_out;                      // The time limit was reached
+} SimResult;
+
+#endif  // SIM_BASE_H
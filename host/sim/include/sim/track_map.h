@@ -0,0 +1,115 @@
+#ifndef SIM_TRACK_MAP_H
+#define SIM_TRACK_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct TrackProjection
+ * @brief Projection of a point on the track centerline.
+ */
+typedef struct {
+    float arc;        // Arc length of the projected point in cm
+    float lateral;    // Signed distance from the line in cm, left > 0
+    float heading;    // Track direction at the projected point in radians
+    uint32_t segment; // Index of the segment holding the projection
+} TrackProjection;
+
+/**
+ * @brief Builds the closed track centerline from a waypoint table.
+ * @param xs X coordinates of the waypoints.
+ * @param ys Y coordinates of the waypoints.
+ * @param count Number of waypoints.
+ * @param unit Length of one waypoint unit in cm.
+ * @param line_width Width of the line in cm.
+ * @return true if the map was built, false otherwise.
+ * @note The last waypoint connects back to the first, like the pure pursuit
+ * waypoint iteration does.
+ */
+bool init_track_map(const float* const xs, const float* const ys,
+                    const uint32_t count, const float unit,
+                    const float line_width);
+
+/**
+ * @brief Releases the memory held by the track map.
+ */
+void free_track_map(void);
+
+/**
+ * @brief Gets the total length of the track centerline.
+ * @return The track length in cm.
+ */
+float get_track_length(void);
+
+/**
+ * @brief Gets the bounding box of the track centerline.
+ * @param width Pointer to store the extent along X in cm.
+ * @param height Pointer to store the extent along Y in cm.
+ */
+void get_track_size(float* const width, float* const height);
+
+/**
+ * @brief Gets the pose of the centerline at a given arc length.
+ * @param arc The arc length in cm, wrapped around the track length.
+ * @param x Pointer to store the X coordinate in cm.
+ * @param y Pointer to store the Y coordinate in cm.
+ * @param heading Pointer to store the track direction in radians.
+ */
+void get_track_pose(float arc, float* x, float* y, float* heading);
+
+/**
+ * @brief Projects a point on the whole track centerline.
+ * @param x X coordinate of the point in cm.
+ * @param y Y coordinate of the point in cm.
+ * @return The projection on the closest segment.
+ * @note Linear in the number of segments, meant for initialization only.
+ */
+TrackProjection project_on_track(const float x, const float y);
+
+/**
+ * @brief Projects a point on the track near a previous projection.
+ * @param x X coordinate of the point in cm.
+ * @param y Y coordinate of the point in cm.
+ * @param previous The last projection of the same point.
+ * @return The projection on the closest segment around the previous one.
+ * @note Keeps following the same stretch of track at self crossings.
+ */
+TrackProjection follow_on_track(const float x, const float y,
+                                const TrackProjection* const previous);
+
+/**
+ * @brief Computes how much of a circular footprint is covered by the line.
+ * @param x X coordinate of the footprint center in cm.
+ * @param y Y coordinate of the footprint center in cm.
+ * @param radius Radius of the footprint in cm.
+ * @param local Projection of the robot on the stretch of track it follows.
+ * @return The covered fraction in [0, 1].
+ * @note The line around the local projection is always drawn, while the rest
+ * of the track is only drawn where it crosses it steeply. This keeps real
+ * crossings and hides near-parallel passes of tables recorded over several
+ * laps.
+ */
+float get_line_coverage(const float x, const float y, const float radius,
+                        const TrackProjection* const local);
+
+/**
+ * @brief Adds a side marker to the track.
+ * @param arc Arc length of the marker center in cm.
+ * @param lateral Signed distance of the marker center from the line in cm,
+ * left > 0.
+ * @param length Length of the marker along the track in cm.
+ * @param width Width of the marker across the track in cm.
+ * @return true if the marker was added, false if the marker list is full.
+ */
+bool add_track_marker(const float arc, const float lateral, const float length,
+                      const float width);
+
+/**
+ * @brief Checks if a point lies on any side marker.
+ * @param x X coordinate of the point in cm.
+ * @param y Y coordinate of the point in cm.
+ * @return true if the point is over a marker, false otherwise.
+ */
+bool is_over_marker(const float x, const float y);
+
+#endif  // SIM_TRACK_MAP_H
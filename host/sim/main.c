@@ -0,0 +1,177 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "pid/pid.h"
+#include "sim/report.h"
+#include "sim/sim.h"
+#include "state_machine/state_machine_base.h"
+
+#define PURE_PURSUIT_SPEED 75.0f  // cm/s
+#define MS_PER_S 1000.0f
+
+// Thermal drift scenario, a warming MPU whose yaw bias follows its temperature
+#define DRIFT_TEMPERATURE_RAMP 2.0f  // °C per minute
+#define DRIFT_GYRO_BIAS_RAMP 0.05f   // deg/s per minute
+
+// Runs that take several times as long as the laps would at a typical speed
+// are stopped and reported as timed out
+#define TYPICAL_SPEED 50.0f       // cm/s
+#define LAP_TIME_LIMIT 4.0f       // Times the typical lap time
+#define START_TIME_LIMIT_MS 10000  // Boot and start sequence before driving
+
+// Fast background scenario, discharging within the IR read timeout so the
+// adaptive window and the PID frame timing can shrink
+#define FAST_BACKGROUND_DISCHARGE_US 250
+
+static double wall_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void print_usage(const char* const name) {
+    fprintf(stderr,
+            "Usage: %s [pid|pure_pursuit] [laps] [--drift] [--window] "
+            "[--min-frame] [--csv]\n",
+            name);
+}
+
+static uint32_t get_time_limit_ms(const uint8_t laps) {
+    const float lap_ms =
+        get_sim_track()->length / TYPICAL_SPEED * MS_PER_S;
+    return START_TIME_LIMIT_MS + (uint32_t)(LAP_TIME_LIMIT * laps * lap_ms);
+}
+
+static bool check_frame_timing(const SimResult* const result,
+                               const bool window, const bool min_frame) {
+    // The PID frames must complete earlier once the window has adapted
+    if (window && result->last_sample_us >= result->first_sample_us) {
+        fprintf(stderr, "PID frame timing did not follow the read window\n");
+        return false;
+    }
+
+    if (min_frame && result->deadline_overruns) {
+        fprintf(stderr, "The shortest PID frame overran\n");
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint8_t running_mode = RUNNING_PID;
+    const char* mode_name = "pid";
+    uint8_t laps = 1;
+    bool csv = false;
+    bool drift = false;
+    bool window = false;
+    bool min_frame = false;
+
+    // Flags may follow the positional arguments in any order
+    while (argc > 1 && strncmp(argv[argc - 1], "--", 2) == 0) {
+        if (strcmp(argv[argc - 1], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[argc - 1], "--drift") == 0) {
+            drift = true;
+        } else if (strcmp(argv[argc - 1], "--window") == 0) {
+            window = true;
+        } else if (strcmp(argv[argc - 1], "--min-frame") == 0) {
+            min_frame = true;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        argc--;
+    }
+
+    if (argc > 1) {
+        mode_name = argv[1];
+        if (strcmp(argv[1], "pid") == 0) {
+            running_mode = RUNNING_PID;
+        } else if (strcmp(argv[1], "pure_pursuit") == 0) {
+            running_mode = RUNNING_PURE_PURSUIT;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc > 2) laps = (uint8_t)atoi(argv[2]);
+
+    SimConfig config = get_default_sim_config();
+    config.max_time_ms = get_time_limit_ms(laps);
+    if (drift) {
+        config.temperature_ramp = DRIFT_TEMPERATURE_RAMP;
+        config.gyro_bias_ramp = DRIFT_GYRO_BIAS_RAMP;
+    }
+    if (window) config.black_discharge_us = FAST_BACKGROUND_DISCHARGE_US;
+
+    if (!init_sim(&config)) {
+        fprintf(stderr, "Failed to build track %s at its real size\n",
+                get_sim_track_name());
+        return EXIT_FAILURE;
+    }
+
+    const uint8_t stop_mode = STOP_MODE_LAPS;
+    send_sim_command(RUNNING_MODE, &running_mode);
+
+    // The default pure pursuit speed stays on the lap markers long enough for
+    // them to be counted twice
+    const uint16_t base_speed = (uint16_t)(PURE_PURSUIT_SPEED * 100.0f);
+    const uint8_t base_speed_payload[2] = {base_speed & 0xFF, base_speed >> 8};
+    if (running_mode == RUNNING_PURE_PURSUIT) {
+        send_sim_command(BASE_SPEED, base_speed_payload);
+    }
+
+    // The shortest frame the firmware accepts must not trip the supervisor
+    const uint16_t frame = get_pid_min_frame_interval();
+    const uint8_t frame_payload[2] = {frame & 0xFF, frame >> 8};
+    if (min_frame) send_sim_command(PID_FRAME, frame_payload);
+
+    send_sim_command(STOP_MODE, &stop_mode);
+    send_sim_command(LAPS, &laps);
+    send_sim_command(START, NULL);
+
+    const double start_ms = wall_time_ms();
+    const SimResult* const result = run_sim();
+    const double elapsed_ms = wall_time_ms() - start_ms;
+
+    const bool passed =
+        check_frame_timing(result, window && running_mode == RUNNING_PID,
+                           min_frame) &&
+        result->finished;
+
+    if (csv) {
+        write_sim_csv_row(stdout, mode_name, result);
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    printf("track %s, %s\n", get_sim_track_name(), get_sim_status(result));
+    for (uint8_t i = 0; i < result->laps && i < SIM_MAX_LAPS; i++) {
+        printf("lap %u: %u ms\n", i + 1, result->lap_times_ms[i]);
+    }
+    printf("driving time: %u ms, distance: %.1f cm\n", result->run_time_ms,
+           (double)result->distance);
+    printf("cross-track error: max %.2f cm, rms %.2f cm\n",
+           (double)result->max_cross_track, (double)result->rms_cross_track);
+    printf("gyro heading error: max %.2f deg\n",
+           (double)result->max_heading_error);
+    printf("line lost: left %u, right %u, pitch %u\n", result->lost_left,
+           result->lost_right, result->lost_pitch);
+    printf("control loop: %u ticks, %.1f us period, %.1f ns cpu per tick\n",
+           result->control_ticks, (double)result->tick_period_us,
+           (double)result->cpu_ns_per_tick);
+    printf("supervisor: %u overruns, %u watchdog expiries%s\n",
+           result->deadline_overruns, result->watchdog_expiries,
+           result->safe_stopped ? ", safe-stopped" : "");
+    printf("pid frame: sample at %u us, then %u us, min frame %u us\n",
+           result->first_sample_us, result->last_sample_us,
+           result->min_frame_us);
+    printf("simulated %.3f s in %.1f ms\n", result->sim_time_us / 1e6,
+           elapsed_ms);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,201 @@
+#include "sim/plant.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal/encoders.h"
+#include "hal/host/clock.h"
+#include "hal/host/registers.h"
+#include "hal/ir_sensors.h"
+#include "hal/pwm.h"
+#include "hal/spi.h"
+#include "math/math.h"
+#include "sim/track_map.h"
+
+#define CM_PER_PULSE \
+    (WHEEL_DIAMETER_MM * MATH_PI / 10.0f / ENCODER_PULSES_PER_REV)
+
+#define GYRO_LSB_PER_DPS 16.4f  // +/- 2000 deg/s full scale
+#define ACCEL_LSB_PER_G 16384   // +/- 2g full scale
+#define TEMP_LSB_PER_C 333.87f
+#define TEMP_OFFSET_C 21.0f
+#define RAD_TO_DEG (180.0f / MATH_PI)
+#define S_PER_MIN 60.0f
+
+#define SIDE_SENSOR_COVERAGE 0.5f  // Line coverage that pulls a side pin low
+
+static SimPlant plant = {0};
+static const SimConfig* config = NULL;
+
+static TrackProjection bar_projection = {0};
+static float left_pulses = 0.0f;
+static float right_pulses = 0.0f;
+static uint32_t noise_state = 0;
+static float elapsed_min = 0.0f;
+
+static inline float noise(void) {
+    // xorshift32, uniform in [-1, 1]
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    return (float)noise_state / (float)UINT32_MAX * 2.0f - 1.0f;
+}
+
+static inline void write_mpu_word(const uint8_t reg, const float value) {
+    int32_t raw = (int32_t)lroundf(value);
+    if (raw > INT16_MAX) raw = INT16_MAX;
+    if (raw < INT16_MIN) raw = INT16_MIN;
+
+    uint8_t* const mpu = get_host_registers()->mpu;
+    mpu[reg] = (uint8_t)((uint16_t)raw >> 8);
+    mpu[reg + 1] = (uint8_t)((uint16_t)raw & 0xFF);
+}
+
+static inline float get_wheel_target(const uint32_t pwm, const bool forward) {
+    const float speed = (float)pwm / MAX_PWM * config->max_wheel_speed;
+    return forward ? speed : -speed;
+}
+
+static void update_dynamics(const float dt) {
+    const HostRegisters* const regs = get_host_registers();
+
+    float left_target = 0.0f;
+    float right_target = 0.0f;
+    if (regs->tim2_enabled) {
+        left_target = get_wheel_target(regs->tim2_ccr2, regs->motor_left_forward);
+        right_target =
+            get_wheel_target(regs->tim2_ccr3, regs->motor_right_forward);
+    }
+
+    const float alpha = dt / (config->motor_time_constant + dt);
+    plant.left_speed += (left_target - plant.left_speed) * alpha;
+    plant.right_speed += (right_target - plant.right_speed) * alpha;
+
+    const float speed = 0.5f * (plant.left_speed + plant.right_speed);
+    plant.yaw_rate = (plant.right_speed - plant.left_speed) / config->wheel_base;
+
+    const float mid_heading = plant.heading + 0.5f * plant.yaw_rate * dt;
+    plant.x += speed * dt * cosf(mid_heading);
+    plant.y += speed * dt * sinf(mid_heading);
+    plant.heading += plant.yaw_rate * dt;
+    normalize_angle(&plant.heading);
+
+    plant.distance += fabsf(speed) * dt;
+}
+
+static void update_encoders(const float dt) {
+    HostRegisters* const regs = get_host_registers();
+
+    left_pulses += plant.left_speed * dt / CM_PER_PULSE;
+    right_pulses += plant.right_speed * dt / CM_PER_PULSE;
+
+    const int32_t left_counts = (int32_t)left_pulses;
+    const int32_t right_counts = (int32_t)right_pulses;
+    left_pulses -= (float)left_counts;
+    right_pulses -= (float)right_counts;
+
+    if (regs->tim3_enabled) regs->tim3_cnt += (uint16_t)left_counts;
+    if (regs->tim4_enabled) regs->tim4_cnt += (uint16_t)right_counts;
+}
+
+static void update_mpu(void) {
+    // Both ramps start with the simulation, as a warming sensor would drift
+    const float bias =
+        config->gyro_bias + config->gyro_bias_ramp * elapsed_min;
+    const float temperature =
+        config->temperature + config->temperature_ramp * elapsed_min;
+
+    const float gyro_z =
+        plant.yaw_rate * RAD_TO_DEG + bias + config->gyro_noise * noise();
+
+    write_mpu_word(GYRO_REG_Z, gyro_z * GYRO_LSB_PER_DPS);
+    write_mpu_word(TEMP_REG, (temperature - TEMP_OFFSET_C) * TEMP_LSB_PER_C);
+    update_host_mpu_fifo(peek_host_clock_ns());
+}
+
+static void update_ir_sensors(void) {
+    HostRegisters* const regs = get_host_registers();
+
+    const float cos_h = cosf(plant.heading);
+    const float sin_h = sinf(plant.heading);
+    const float bar_x = plant.x + config->sensor_offset * cos_h;
+    const float bar_y = plant.y + config->sensor_offset * sin_h;
+
+    bar_projection = follow_on_track(bar_x, bar_y, &bar_projection);
+    plant.cross_track = bar_projection.lateral;
+    plant.progress = bar_projection.arc;
+
+    // Sensor 0 is the rightmost one, lateral offsets are left positive
+    for (uint8_t i = 0; i < TOTAL_CENTRAL_SENSORS; i++) {
+        const float lateral =
+            ((float)i - 0.5f * (TOTAL_CENTRAL_SENSORS - 1)) *
+            config->sensor_pitch;
+        const float coverage =
+            get_line_coverage(bar_x - lateral * sin_h, bar_y + lateral * cos_h,
+                              config->sensor_radius, &bar_projection);
+
+        const float discharge =
+            config->white_discharge_us +
+            (1.0f - coverage) *
+                (config->black_discharge_us - config->white_discharge_us);
+        regs->ir_discharge_us[i] = discharge >= IR_DISCHARGE_NEVER
+                                       ? IR_DISCHARGE_NEVER
+                                       : (uint16_t)discharge;
+    }
+
+    // Side pins are [left, right] and read low over a marker
+    const float side_lateral[TOTAL_SIDE_SENSORS] = {
+        config->side_sensor_offset, -config->side_sensor_offset};
+
+    for (uint8_t i = 0; i < TOTAL_SIDE_SENSORS; i++) {
+        const float x = bar_x - side_lateral[i] * sin_h;
+        const float y = bar_y + side_lateral[i] * cos_h;
+
+        bool active = is_over_marker(x, y);
+        if (config->side_sensors_see_line && !active) {
+            active = get_line_coverage(x, y, config->sensor_radius,
+                                       &bar_projection) >= SIDE_SENSOR_COVERAGE;
+        }
+
+        regs->side_sensor_pins[i] = !active;
+    }
+
+    side_capture_irq_handler();
+}
+
+const SimPlant* init_plant(const SimConfig* const sim_config,
+                           const float arc) {
+    config = sim_config;
+    noise_state = config->seed ? config->seed : 1;
+    left_pulses = 0.0f;
+    right_pulses = 0.0f;
+
+    float bar_x, bar_y, heading;
+    get_track_pose(arc, &bar_x, &bar_y, &heading);
+
+    plant = (SimPlant){0};
+    plant.heading = heading;
+    plant.x = bar_x - config->sensor_offset * cosf(heading);
+    plant.y = bar_y - config->sensor_offset * sinf(heading);
+
+    bar_projection = project_on_track(bar_x, bar_y);
+
+    elapsed_min = 0.0f;
+    write_mpu_word(ACCEL_REG_Z, ACCEL_LSB_PER_G);
+
+    update_mpu();
+    update_ir_sensors();
+
+    return &plant;
+}
+
+const SimPlant* get_plant(void) { return &plant; }
+
+void update_plant(const float dt) {
+    elapsed_min += dt / S_PER_MIN;
+    update_dynamics(dt);
+    update_encoders(dt);
+    update_mpu();
+    update_ir_sensors();
+}
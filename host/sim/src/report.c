@@ -0,0 +1,61 @@
+#include "sim/report.h"
+
+#include <stddef.h>
+
+#include "config.h"
+
+static const SimTrack TRACKS[] = {
+    [BASE_SQUARE] = {"base_square", 50.0f, 50.0f, 200.0f},
+    [INVERSE_SQUARE] = {"inverse_square", 50.0f, 50.0f, 200.0f},
+    [BASE_TRIANGLE] = {"base_triangle", 50.0f, 50.0f, 162.0f},
+    [INVERSE_TRIANGLE] = {"inverse_triangle", 50.0f, 50.0f, 162.0f},
+    [STAR] = {"star", 50.0f, 50.0f, 274.0f},
+    [HEART] = {"heart", 50.0f, 50.0f, 161.0f},
+    [PET] = {"pet", 184.0f, 93.0f, 599.0f},
+    // Nine and a half passes over the PET track
+    [PET_COMPLEX] = {"pet_complex", 199.0f, 117.0f, 5655.0f},
+    // Close to two passes over a 0.5 meter square
+    [WAYPOINT_TEST] = {"waypoint_test", 50.0f, 50.0f, 368.0f},
+};
+
+#define TRACK_COUNT (sizeof(TRACKS) / sizeof(TRACKS[0]))
+
+static uint32_t mean_lap_time_ms(const SimResult* const result) {
+    const uint8_t laps =
+        result->laps < SIM_MAX_LAPS ? result->laps : SIM_MAX_LAPS;
+    if (!laps) return 0;
+
+    uint64_t total_ms = 0;
+    for (uint8_t i = 0; i < laps; i++) total_ms += result->lap_times_ms[i];
+
+    return (uint32_t)(total_ms / laps);
+}
+
+const SimTrack* get_sim_track(void) {
+    // Unknown tracks fall back to the base square, as in track_selector.h
+    if ((size_t)SELECTED_TRACK >= TRACK_COUNT) return &TRACKS[BASE_SQUARE];
+
+    return &TRACKS[SELECTED_TRACK];
+}
+
+const char* get_sim_track_name(void) { return get_sim_track()->name; }
+
+const char* get_sim_status(const SimResult* const result) {
+    if (result->finished) return "finished";
+    if (result->stopped) return "stopped";
+    if (result->off_track) return "off_track";
+    return "timed_out";
+}
+
+void write_sim_csv_row(FILE* const file, const char* const mode,
+                       const SimResult* const result) {
+    fprintf(file,
+            "%s,%s,%s,%u,%u,%u,%.1f,%.3f,%.3f,%u,%u,%u,%u,%.1f,%.1f,%.3f\n",
+            get_sim_track_name(), mode, get_sim_status(result), result->laps,
+            mean_lap_time_ms(result), result->run_time_ms,
+            (double)result->distance, (double)result->max_cross_track,
+            (double)result->rms_cross_track, result->lost_left,
+            result->lost_right, result->lost_pitch, result->control_ticks,
+            (double)result->tick_period_us, (double)result->cpu_ns_per_tick,
+            (double)result->max_heading_error);
+}
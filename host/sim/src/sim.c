@@ -0,0 +1,323 @@
+#include "sim/sim.h"
+
+#include <math.h>
+#include <setjmp.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "hal/host/clock.h"
+#include "hal/host/registers.h"
+#include "hal/host/serial.h"
+#include "math/math.h"
+#include "pid/pid.h"
+#include "sensors/mpu.h"
+#include "sim/plant.h"
+#include "sim/report.h"
+#include "sim/track_map.h"
+#include "state_machine/handlers/config_handler.h"
+#include "state_machine/state_machine.h"
+#include "supervisor/supervisor.h"
+#include "track/track.h"
+#include "track/track_selector.h"
+
+#define US_PER_MS 1000ULL
+#define US_PER_S 1e6f
+#define NS_PER_S 1000000000ULL
+#define CLOCK_CALIBRATION_READS 100000U
+#define RAD_TO_DEG (180.0f / MATH_PI)
+#define TRACK_SIZE_TOLERANCE 0.25f  // Allowed mismatch with the real track
+
+static SimConfig config = {0};
+static SimResult result = {0};
+static jmp_buf sim_exit;
+
+static uint64_t last_step_us = 0;
+static uint64_t lap_start_us = 0;
+static uint64_t run_time_us = 0;
+static bool lap_in_progress = false;
+static bool running_seen = false;
+static double cross_track_sq_sum = 0.0;
+static float start_heading = 0.0f;
+
+static bool driving_seen = false;
+static uint64_t firmware_cpu_ns = 0;
+static uint64_t hook_exit_cpu_ns = 0;
+static uint64_t hook_exit_clock_reads = 0;
+static double clock_read_cpu_ns = 0.0;
+static uint32_t last_read_count = 0;
+
+static inline uint64_t cpu_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+static inline bool motors_driven(void) {
+    const HostRegisters* const regs = get_host_registers();
+    return regs->tim2_enabled && (regs->tim2_ccr2 || regs->tim2_ccr3);
+}
+
+static void update_laps(const uint64_t now_us) {
+    const TrackCounters* const track = get_track();
+
+    // The first marker of a lap sets the section, the second one counts it
+    if (!lap_in_progress && track->section != 0) {
+        lap_start_us = now_us;
+        lap_in_progress = true;
+    }
+
+    if (track->laps > result.laps) {
+        if (result.laps < SIM_MAX_LAPS) {
+            result.lap_times_ms[result.laps] =
+                (uint32_t)((now_us - lap_start_us) / US_PER_MS);
+        }
+
+        result.laps = track->laps;
+        lap_in_progress = false;
+    }
+}
+
+static void update_cross_track(void) {
+    const float cross_track = fabsf(get_plant()->cross_track);
+
+    if (cross_track > result.max_cross_track) {
+        result.max_cross_track = cross_track;
+    }
+
+    cross_track_sq_sum += (double)cross_track * (double)cross_track;
+    result.cross_track_samples++;
+
+    if (cross_track > config.off_track_distance) result.off_track = true;
+}
+
+// The gyro yaw starts from zero with every run, the plant heading does not
+static void update_heading_error(void) {
+    float error = get_mpu_data()->yaw - (get_plant()->heading - start_heading);
+    normalize_angle(&error);
+    error = fabsf(error) * RAD_TO_DEG;
+
+    if (error > result.max_heading_error) result.max_heading_error = error;
+}
+
+static void update_track_counters(void) {
+    const TrackCounters* const track = get_track();
+
+    result.lost_left = track->lost_left_counter;
+    result.lost_right = track->lost_right_counter;
+    result.lost_pitch = track->lost_pitch_counter;
+}
+
+static void update_control_load(const uint64_t hook_entry_cpu_ns) {
+    const uint32_t read_count = get_host_registers()->ir_read_count;
+    const uint64_t clock_reads = get_host_clock_reads();
+
+    // Neither the hook nor the clock polling is the firmware's own work
+    if (driving_seen) {
+        const uint64_t cpu_ns = hook_entry_cpu_ns - hook_exit_cpu_ns;
+        const uint64_t clock_ns = (uint64_t)(
+            (double)(clock_reads - hook_exit_clock_reads) * clock_read_cpu_ns);
+        firmware_cpu_ns += cpu_ns > clock_ns ? cpu_ns - clock_ns : 0;
+        result.control_ticks += read_count - last_read_count;
+    }
+
+    last_read_count = read_count;
+    driving_seen = true;
+}
+
+static bool update_result(const uint64_t now_us, const uint64_t dt_us,
+                          const uint64_t hook_entry_cpu_ns) {
+    const StateMachine* const sm = get_state_machine();
+
+    if (sm->current_state == STATE_RUNNING) {
+        if (!running_seen) {
+            start_heading = get_plant()->heading;
+            result.first_sample_us = get_pid_sample_point();
+        }
+        running_seen = true;
+        update_laps(now_us);
+        update_track_counters();
+
+        if (motors_driven()) {
+            run_time_us += dt_us;
+            update_control_load(hook_entry_cpu_ns);
+            update_cross_track();
+            update_heading_error();
+        }
+    } else if (running_seen) {
+        // Safe-stops and early stops leave RUNNING too, without the laps
+        result.stopped = true;
+        result.finished =
+            result.laps >= sm->laps && !get_supervisor()->tripped;
+    }
+
+    result.timed_out = now_us >= config.max_time_ms * US_PER_MS;
+
+    return result.stopped || result.off_track || result.timed_out;
+}
+
+static void step_sim(const uint64_t now_us) {
+    const uint64_t hook_entry_cpu_ns = cpu_time_ns();
+    const uint64_t dt_us = now_us - last_step_us;
+    last_step_us = now_us;
+
+    update_plant((float)dt_us / US_PER_S);
+    const bool done = update_result(now_us, dt_us, hook_entry_cpu_ns);
+
+    hook_exit_cpu_ns = cpu_time_ns();
+    hook_exit_clock_reads = get_host_clock_reads();
+    if (!done) return;
+
+    result.sim_time_us = now_us;
+    longjmp(sim_exit, 1);
+}
+
+static void finalize_result(void) {
+    result.run_time_ms = (uint32_t)(run_time_us / US_PER_MS);
+    result.distance = get_plant()->distance;
+
+    if (result.cross_track_samples) {
+        result.rms_cross_track =
+            (float)sqrt(cross_track_sq_sum / result.cross_track_samples);
+    }
+
+    const Supervisor* const supervisor = get_supervisor();
+    result.deadline_overruns = supervisor->overruns;
+    result.safe_stopped = supervisor->tripped;
+    result.watchdog_expiries = get_host_registers()->iwdg_expiries;
+    result.last_sample_us = get_pid_sample_point();
+    result.min_frame_us = get_pid_min_frame_interval();
+
+    if (result.control_ticks) {
+        result.tick_period_us = (float)run_time_us / result.control_ticks;
+        result.cpu_ns_per_tick = (float)firmware_cpu_ns / result.control_ticks;
+    }
+}
+
+SimConfig get_default_sim_config(void) {
+    return (SimConfig){
+        .wheel_base = 14.3f,
+        .max_wheel_speed = 250.0f,
+        .motor_time_constant = 0.03f,
+        .sensor_offset = 8.0f,
+        .sensor_pitch = 0.8f,
+        .sensor_radius = 0.3f,
+        .side_sensor_offset = 5.5f,
+        .side_sensors_see_line = false,
+        .line_width = 1.9f,
+        .marker_offset = 5.5f,
+        .marker_length = 2.0f,
+        .marker_width = 2.0f,
+        .start_marker_offset = 10.0f,
+        .white_discharge_us = 50,
+        .black_discharge_us = 550,
+        .gyro_bias = 0.0f,
+        .gyro_noise = 0.0f,
+        .temperature = 25.0f,
+        .gyro_bias_ramp = 0.0f,
+        .temperature_ramp = 0.0f,
+        .off_track_distance = 15.0f,
+        .step_us = 200,
+        .clock_read_ns = 4000,
+        .max_time_ms = 3600000,
+        .seed = 1,
+    };
+}
+
+static inline bool matches_real_size(const float size, const float real) {
+    return fabsf(size - real) <= TRACK_SIZE_TOLERANCE * real;
+}
+
+// Catches tables in other units than WAYPOINT_UNIT_CM says
+static bool check_track_scale(void) {
+    const SimTrack* const real = get_sim_track();
+    float width, height;
+    get_track_size(&width, &height);
+
+    return matches_real_size(width, real->width) &&
+           matches_real_size(height, real->height) &&
+           matches_real_size(get_track_length(), real->length);
+}
+
+// Measured without a hook or alarm, so it is the bare cost of a polling read
+static void calibrate_clock_reads(void) {
+    const uint64_t start_ns = cpu_time_ns();
+    for (uint32_t i = 0; i < CLOCK_CALIBRATION_READS; i++) {
+        (void)read_host_clock_ns();
+    }
+    clock_read_cpu_ns =
+        (double)(cpu_time_ns() - start_ns) / CLOCK_CALIBRATION_READS;
+
+    set_host_clock_mode(HOST_CLOCK_VIRTUAL);  // Back to zero
+}
+
+bool init_sim(const SimConfig* const sim_config) {
+    config = *sim_config;
+    result = (SimResult){0};
+
+    reset_host_registers();
+    set_host_usart_pty(false);
+    set_host_clock_mode(HOST_CLOCK_VIRTUAL);
+    set_host_clock_read_cost(config.clock_read_ns);
+    calibrate_clock_reads();
+
+    if (!init_track_map(waypoints_x, waypoints_y, WAYPOINT_COUNT,
+                        WAYPOINT_UNIT_CM, config.line_width)) {
+        return false;
+    }
+    if (!check_track_scale()) {
+        free_track_map();
+        return false;
+    }
+
+    // Odometry starts at the origin, so the axle is placed on the track there
+    const float start = project_on_track(0.0f, 0.0f).arc;
+    const float bar_start = start + config.sensor_offset;
+    const float length = get_track_length();
+
+    add_track_marker(bar_start + config.start_marker_offset,
+                     -config.marker_offset, config.marker_length,
+                     config.marker_width);
+    add_track_marker(bar_start + length - config.start_marker_offset,
+                     -config.marker_offset, config.marker_length,
+                     config.marker_width);
+
+    init_plant(&config, bar_start);
+    return true;
+}
+
+bool send_sim_command(const SerialMessages msg, const uint8_t* const payload) {
+    if (msg >= SERIAL_MESSAGE_COUNT) return false;
+
+    uint8_t frame[SERIAL_MESSAGE_MAX_PAYLOAD + 1] = {(uint8_t)msg};
+    const uint8_t size = SERIAL_MESSAGE_SIZES[msg];
+
+    for (uint8_t i = 0; i < size && payload; i++) frame[i + 1] = payload[i];
+
+    return inject_host_usart_rx(frame, size + 1);
+}
+
+const SimResult* run_sim(void) {
+    last_step_us = 0;
+    lap_start_us = 0;
+    run_time_us = 0;
+    lap_in_progress = false;
+    running_seen = false;
+    cross_track_sq_sum = 0.0;
+    start_heading = 0.0f;
+    driving_seen = false;
+    firmware_cpu_ns = 0;
+    hook_exit_cpu_ns = cpu_time_ns();
+    hook_exit_clock_reads = get_host_clock_reads();
+    last_read_count = get_host_registers()->ir_read_count;
+
+    if (setjmp(sim_exit) == 0) {
+        set_host_clock_hook(step_sim, config.step_us);
+        run_state_machine();
+        result.sim_time_us = peek_host_clock_ns() / 1000ULL;
+    }
+
+    set_host_clock_hook(NULL, 0);
+    finalize_result();
+
+    return &result;
+}
@@ -0,0 +1,384 @@
+#include "sim/track_map.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define GRID_CELL_CM 4.0f     // Side of the lookup grid cells
+#define GRID_MARGIN_CM 2.0f   // Segment bounds padding, above line + footprint
+#define FOLLOW_WINDOW 4       // Segments searched around the last projection
+#define MAX_MARKERS 16
+
+// Stretch of line around the robot that is always drawn
+#define LOCAL_ARC_CM 30.0f
+
+// Other stretches are only drawn where they cross the local one steeply,
+// hiding the near-parallel passes of tables recorded over several laps
+#define CROSSING_MAX_COS 0.5f  // cos(60°)
+
+typedef struct {
+    float cx;        // Marker center X in cm
+    float cy;        // Marker center Y in cm
+    float cos_h;     // Cosine of the track direction at the marker
+    float sin_h;     // Sine of the track direction at the marker
+    float half_len;  // Half length along the track in cm
+    float half_wid;  // Half width across the track in cm
+} Marker;
+
+static struct {
+    float* x;           // Segment start X coordinates
+    float* y;           // Segment start Y coordinates
+    float* arc;         // Arc length at each segment start
+    float* length;      // Segment lengths
+    float* ux;          // Segment direction X components
+    float* uy;          // Segment direction Y components
+    uint32_t segments;  // Number of segments (and points)
+    float total_length;
+    float half_width;
+    float width;        // Bounding box extent along X
+    float height;       // Bounding box extent along Y
+} track = {0};
+
+static struct {
+    float min_x;
+    float min_y;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t* cell_start;  // Offsets of each cell in the items list
+    uint32_t* items;       // Segment indexes grouped by cell
+} grid = {0};
+
+static Marker markers[MAX_MARKERS];
+static uint8_t marker_count = 0;
+
+static inline uint32_t next_point(const uint32_t i) {
+    return (i + 1 == track.segments) ? 0 : i + 1;
+}
+
+static inline int32_t clamp_index(const float value, const uint32_t size) {
+    const int32_t index = (int32_t)floorf(value);
+    if (index < 0) return 0;
+    if (index >= (int32_t)size) return (int32_t)size - 1;
+    return index;
+}
+
+static TrackProjection project_on_segment(const uint32_t i, const float x,
+                                          const float y, float* dist_sq) {
+    const float ux = track.ux[i];
+    const float uy = track.uy[i];
+    const float len = track.length[i];
+
+    const float px = x - track.x[i];
+    const float py = y - track.y[i];
+
+    float t = px * ux + py * uy;
+    if (t < 0.0f) t = 0.0f;
+    if (t > len) t = len;
+
+    const float ex = px - t * ux;
+    const float ey = py - t * uy;
+    *dist_sq = ex * ex + ey * ey;
+
+    const float side = ux * py - uy * px;
+    const float dist = sqrtf(*dist_sq);
+
+    return (TrackProjection){
+        .arc = track.arc[i] + t,
+        .lateral = side >= 0.0f ? dist : -dist,
+        .heading = atan2f(uy, ux),
+        .segment = i,
+    };
+}
+
+static void segment_cells(const uint32_t i, int32_t* c0, int32_t* r0,
+                          int32_t* c1, int32_t* r1) {
+    const uint32_t j = next_point(i);
+
+    const float min_x = fminf(track.x[i], track.x[j]) - GRID_MARGIN_CM;
+    const float max_x = fmaxf(track.x[i], track.x[j]) + GRID_MARGIN_CM;
+    const float min_y = fminf(track.y[i], track.y[j]) - GRID_MARGIN_CM;
+    const float max_y = fmaxf(track.y[i], track.y[j]) + GRID_MARGIN_CM;
+
+    *c0 = clamp_index((min_x - grid.min_x) / GRID_CELL_CM, grid.cols);
+    *c1 = clamp_index((max_x - grid.min_x) / GRID_CELL_CM, grid.cols);
+    *r0 = clamp_index((min_y - grid.min_y) / GRID_CELL_CM, grid.rows);
+    *r1 = clamp_index((max_y - grid.min_y) / GRID_CELL_CM, grid.rows);
+}
+
+static bool build_grid(void) {
+    float min_x = track.x[0], max_x = track.x[0];
+    float min_y = track.y[0], max_y = track.y[0];
+
+    for (uint32_t i = 1; i < track.segments; i++) {
+        min_x = fminf(min_x, track.x[i]);
+        max_x = fmaxf(max_x, track.x[i]);
+        min_y = fminf(min_y, track.y[i]);
+        max_y = fmaxf(max_y, track.y[i]);
+    }
+
+    track.width = max_x - min_x;
+    track.height = max_y - min_y;
+
+    grid.min_x = min_x - 2.0f * GRID_MARGIN_CM;
+    grid.min_y = min_y - 2.0f * GRID_MARGIN_CM;
+    grid.cols = (uint32_t)((max_x - grid.min_x) / GRID_CELL_CM) + 2;
+    grid.rows = (uint32_t)((max_y - grid.min_y) / GRID_CELL_CM) + 2;
+
+    const uint32_t cells = grid.cols * grid.rows;
+    grid.cell_start = calloc(cells + 1, sizeof(uint32_t));
+    if (!grid.cell_start) return false;
+
+    // First pass counts the segments of each cell, second pass fills them
+    for (uint32_t i = 0; i < track.segments; i++) {
+        int32_t c0, r0, c1, r1;
+        segment_cells(i, &c0, &r0, &c1, &r1);
+
+        for (int32_t r = r0; r <= r1; r++) {
+            for (int32_t c = c0; c <= c1; c++) {
+                grid.cell_start[r * grid.cols + c + 1]++;
+            }
+        }
+    }
+
+    for (uint32_t cell = 0; cell < cells; cell++) {
+        grid.cell_start[cell + 1] += grid.cell_start[cell];
+    }
+
+    grid.items = malloc(grid.cell_start[cells] * sizeof(uint32_t));
+    uint32_t* fill = calloc(cells, sizeof(uint32_t));
+    if (!grid.items || !fill) {
+        free(fill);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < track.segments; i++) {
+        int32_t c0, r0, c1, r1;
+        segment_cells(i, &c0, &r0, &c1, &r1);
+
+        for (int32_t r = r0; r <= r1; r++) {
+            for (int32_t c = c0; c <= c1; c++) {
+                const uint32_t cell = r * grid.cols + c;
+                grid.items[grid.cell_start[cell] + fill[cell]++] = i;
+            }
+        }
+    }
+
+    free(fill);
+    return true;
+}
+
+bool init_track_map(const float* const xs, const float* const ys,
+                    const uint32_t count, const float unit,
+                    const float line_width) {
+    free_track_map();
+    if (count < 2) return false;
+
+    track.segments = count;
+    track.half_width = 0.5f * line_width;
+    track.x = malloc(count * sizeof(float));
+    track.y = malloc(count * sizeof(float));
+    track.arc = malloc(count * sizeof(float));
+    track.length = malloc(count * sizeof(float));
+    track.ux = malloc(count * sizeof(float));
+    track.uy = malloc(count * sizeof(float));
+
+    if (!track.x || !track.y || !track.arc || !track.length || !track.ux ||
+        !track.uy) {
+        free_track_map();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        track.x[i] = xs[i] * unit;
+        track.y[i] = ys[i] * unit;
+    }
+
+    float arc = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t j = next_point(i);
+        const float dx = track.x[j] - track.x[i];
+        const float dy = track.y[j] - track.y[i];
+
+        track.arc[i] = arc;
+        track.length[i] = hypotf(dx, dy);
+        track.ux[i] = track.length[i] > 0.0f ? dx / track.length[i] : 1.0f;
+        track.uy[i] = track.length[i] > 0.0f ? dy / track.length[i] : 0.0f;
+        arc += track.length[i];
+    }
+    track.total_length = arc;
+
+    if (!build_grid()) {
+        free_track_map();
+        return false;
+    }
+
+    return true;
+}
+
+void free_track_map(void) {
+    free(track.x);
+    free(track.y);
+    free(track.arc);
+    free(track.length);
+    free(track.ux);
+    free(track.uy);
+    free(grid.cell_start);
+    free(grid.items);
+
+    track = (typeof(track)){0};
+    grid = (typeof(grid)){0};
+    marker_count = 0;
+}
+
+float get_track_length(void) { return track.total_length; }
+
+void get_track_size(float* const width, float* const height) {
+    *width = track.width;
+    *height = track.height;
+}
+
+void get_track_pose(float arc, float* x, float* y, float* heading) {
+    arc = fmodf(arc, track.total_length);
+    if (arc < 0.0f) arc += track.total_length;
+
+    // Last segment starting at or before the arc length
+    uint32_t low = 0;
+    uint32_t high = track.segments - 1;
+    while (low < high) {
+        const uint32_t mid = (low + high + 1) / 2;
+        if (track.arc[mid] <= arc) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    const uint32_t j = next_point(low);
+    const float len = track.length[low];
+    const float t = len > 0.0f ? (arc - track.arc[low]) / len : 0.0f;
+
+    *x = track.x[low] + t * (track.x[j] - track.x[low]);
+    *y = track.y[low] + t * (track.y[j] - track.y[low]);
+    *heading = atan2f(track.y[j] - track.y[low], track.x[j] - track.x[low]);
+}
+
+TrackProjection project_on_track(const float x, const float y) {
+    TrackProjection best = {0};
+    float best_dist_sq = INFINITY;
+
+    for (uint32_t i = 0; i < track.segments; i++) {
+        float dist_sq;
+        const TrackProjection projection = project_on_segment(i, x, y, &dist_sq);
+
+        if (dist_sq < best_dist_sq) {
+            best_dist_sq = dist_sq;
+            best = projection;
+        }
+    }
+
+    return best;
+}
+
+TrackProjection follow_on_track(const float x, const float y,
+                                const TrackProjection* const previous) {
+    if (track.segments <= 2 * FOLLOW_WINDOW) return project_on_track(x, y);
+
+    TrackProjection best = *previous;
+    float best_dist_sq = INFINITY;
+
+    const uint32_t start =
+        (previous->segment + track.segments - FOLLOW_WINDOW) % track.segments;
+
+    for (uint32_t k = 0, i = start; k <= 2 * FOLLOW_WINDOW; k++) {
+        float dist_sq;
+        const TrackProjection projection = project_on_segment(i, x, y, &dist_sq);
+
+        if (dist_sq < best_dist_sq) {
+            best_dist_sq = dist_sq;
+            best = projection;
+        }
+
+        i = next_point(i);
+    }
+
+    return best;
+}
+
+static bool is_segment_visible(const uint32_t i,
+                               const TrackProjection* const local) {
+    // Cyclic arc distance from the local point to the segment span
+    float before = local->arc - (track.arc[i] + track.length[i]);
+    float after = track.arc[i] - local->arc;
+    if (before <= 0.0f && after <= 0.0f) return true;  // Inside the span
+
+    if (before < 0.0f) before += track.total_length;
+    if (after < 0.0f) after += track.total_length;
+    if (before <= LOCAL_ARC_CM || after <= LOCAL_ARC_CM) return true;
+
+    const float cross_cos = track.ux[i] * track.ux[local->segment] +
+                            track.uy[i] * track.uy[local->segment];
+    return fabsf(cross_cos) < CROSSING_MAX_COS;
+}
+
+float get_line_coverage(const float x, const float y, const float radius,
+                        const TrackProjection* const local) {
+    const int32_t c = (int32_t)floorf((x - grid.min_x) / GRID_CELL_CM);
+    const int32_t r = (int32_t)floorf((y - grid.min_y) / GRID_CELL_CM);
+    if (c < 0 || r < 0 || c >= (int32_t)grid.cols || r >= (int32_t)grid.rows) {
+        return 0.0f;
+    }
+
+    const uint32_t cell = r * grid.cols + c;
+    float coverage = 0.0f;
+
+    for (uint32_t k = grid.cell_start[cell]; k < grid.cell_start[cell + 1];
+         k++) {
+        const uint32_t i = grid.items[k];
+        if (!is_segment_visible(i, local)) continue;
+
+        float dist_sq;
+        (void)project_on_segment(i, x, y, &dist_sq);
+
+        // Linear overlap of the footprint with the line edge
+        const float overlap =
+            (track.half_width + radius - sqrtf(dist_sq)) / (2.0f * radius);
+        if (overlap > coverage) coverage = overlap;
+    }
+
+    return coverage > 1.0f ? 1.0f : coverage;
+}
+
+bool add_track_marker(const float arc, const float lateral, const float length,
+                      const float width) {
+    if (marker_count >= MAX_MARKERS) return false;
+
+    float x, y, heading;
+    get_track_pose(arc, &x, &y, &heading);
+
+    Marker* const marker = &markers[marker_count++];
+    marker->cos_h = cosf(heading);
+    marker->sin_h = sinf(heading);
+    marker->cx = x - lateral * marker->sin_h;
+    marker->cy = y + lateral * marker->cos_h;
+    marker->half_len = 0.5f * length;
+    marker->half_wid = 0.5f * width;
+
+    return true;
+}
+
+bool is_over_marker(const float x, const float y) {
+    for (uint8_t i = 0; i < marker_count; i++) {
+        const Marker* const marker = &markers[i];
+        const float dx = x - marker->cx;
+        const float dy = y - marker->cy;
+
+        const float along = dx * marker->cos_h + dy * marker->sin_h;
+        const float across = dy * marker->cos_h - dx * marker->sin_h;
+
+        if (fabsf(along) <= marker->half_len &&
+            fabsf(across) <= marker->half_wid) {
+            return true;
+        }
+    }
+
+    return false;
+}